@@ -0,0 +1,163 @@
+/**
+ * @file bench_presets.cpp
+ * @brief Compares the cost of evaluating the runtime FeatureManager graph
+ * against the equivalent compile-time composed preset from CostModel.hpp.
+ *
+ * Costs are evaluated for every directed edge of every face of a synthetic
+ * grid TIN, so no data needs to be fetched. The data features are left
+ * untagged, so they return their no-data values.
+ *
+ */
+
+#include "tsr/CostModel.hpp"
+#include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/FeatureManager.hpp"
+#include "tsr/Features/DistanceFeature.hpp"
+#include "tsr/Features/GradientFeature.hpp"
+#include "tsr/Features/InverseFeature.hpp"
+#include "tsr/Features/MultiplierFeature.hpp"
+#include "tsr/Logging.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/PresetFeatures.hpp"
+#include "tsr/Presets.hpp"
+#include "tsr/Tin.hpp"
+#include "tsr/TsrState.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace tsr;
+
+namespace {
+
+const int GRID_SIZE = 300;
+const double GRID_SPACING = 30;
+const int ITERATIONS = 5;
+
+Tin CreateGridTin() {
+  std::vector<Point3> points;
+  points.reserve(GRID_SIZE * GRID_SIZE);
+
+  // Gentle rolling terrain, keeping most gradients traversable
+  for (int y = 0; y < GRID_SIZE; y++) {
+    for (int x = 0; x < GRID_SIZE; x++) {
+      double z = 20 * std::sin(x * 0.05) * std::cos(y * 0.07);
+      points.push_back(Point3(x * GRID_SPACING, y * GRID_SPACING, z));
+    }
+  }
+
+  return CreateTinFromPoints(points);
+}
+
+PresetFeatures CreateFeatures() {
+  PresetFeatures features;
+  features.terrain = std::make_shared<CEHTerrainFeature>("terrain_type", 0.1);
+  features.water = std::make_shared<BoolWaterFeature>("water", 0.1);
+  features.paths = std::make_shared<PathFeature>("paths", 0.05);
+  features.gradient_speed =
+      std::make_shared<GradientSpeedFeature>("gradient_speed");
+  features.gradient_speed->AddDependency(
+      std::make_shared<GradientFeature>("gradient"));
+  return features;
+}
+
+/// Runtime graph of distance / gradient speed
+FeatureManager CreateWalkingGraph(const PresetFeatures &features) {
+  FeatureManager fm;
+
+  auto distance = std::make_shared<DistanceFeature>("distance");
+
+  auto inverseSpeed =
+      std::make_shared<InverseFeature<double, double>>("inverse_speed");
+  inverseSpeed->AddDependency(features.gradient_speed);
+
+  auto time = std::make_shared<MultiplierFeature>("time");
+  time->AddDependency(distance, MultiplierFeature::DOUBLE);
+  time->AddDependency(inverseSpeed, MultiplierFeature::DOUBLE);
+
+  fm.SetOutputFeature(time);
+  return fm;
+}
+
+struct BenchResult {
+  double nanoseconds_per_edge;
+  double checksum;
+};
+
+/// Evaluates the cost of every directed edge of every finite face
+template <typename CostFunction>
+BenchResult RunBench(const Tin &tin, const CostFunction &cost) {
+  TsrState state;
+
+  double checksum = 0;
+  size_t evaluations = 0;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+    for (Face_handle face : tin.finite_face_handles()) {
+      state.current_face = face;
+
+      for (int i = 0; i < 3; i++) {
+        state.current_vertex = face->vertex(i);
+
+        for (int j = 1; j < 3; j++) {
+          state.next_vertex = face->vertex((i + j) % 3);
+          checksum += cost.Calculate(state);
+          evaluations++;
+        }
+      }
+    }
+  }
+
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  return {elapsed.count() / evaluations, checksum};
+}
+
+template <typename Model>
+void Compare(const std::string &name, const Tin &tin,
+             const FeatureManager &graph, const Model &model) {
+  auto runtime = RunBench(tin, graph);
+  auto composed = RunBench(tin, model);
+
+  std::cout << name << "\n"
+            << "  runtime graph:   " << runtime.nanoseconds_per_edge
+            << " ns/edge (checksum " << runtime.checksum << ")\n"
+            << "  composed preset: " << composed.nanoseconds_per_edge
+            << " ns/edge (checksum " << composed.checksum << ")\n"
+            << "  speedup:         "
+            << runtime.nanoseconds_per_edge / composed.nanoseconds_per_edge
+            << "x" << std::endl;
+}
+
+} // namespace
+
+int main() {
+  log_set_global_loglevel(LogLevel::ERROR);
+
+  Tin tin = CreateGridTin();
+  std::cout << "Grid TIN: " << tin.number_of_vertices() << " vertices, "
+            << tin.number_of_faces() << " faces" << std::endl;
+
+  PresetFeatures features = CreateFeatures();
+
+  using WalkingModel =
+      Cost::Time<Cost::Distance,
+                 Cost::Inverse<Cost::GradientSpeed<Cost::Gradient>>>;
+
+  Compare("walking (distance / gradient speed)", tin,
+          CreateWalkingGraph(features), WalkingModel(features));
+
+  Compare("time with swimming preset", tin,
+          SetupTimeWithSwimmingPreset(features),
+          Cost::TimeWithSwimmingPreset(features));
+
+  return EXIT_SUCCESS;
+}
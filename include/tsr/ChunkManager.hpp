@@ -56,7 +56,7 @@ public:
   std::vector<ChunkInfo> GetRequiredChunks(const MeshBoundary &boundary) const;
 
   bool IsAvailableInCache(const std::string &feature_id,
-                          const ChunkInfo &chunk);
+                          const ChunkInfo &chunk) const;
 };
 
 void CacheSetEnabled(bool isEnabled);
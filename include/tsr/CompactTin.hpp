@@ -0,0 +1,56 @@
+#pragma once
+
+#include "tsr/Point3.hpp"
+#include "tsr/Tin.hpp"
+
+#include <CGAL/Constrained_Delaunay_triangulation_2.h>
+#include <CGAL/Triangulation_data_structure_2.h>
+#include <CGAL/Triangulation_vertex_base_with_info_2.h>
+
+#include <cstdint>
+
+namespace tsr {
+
+/// Elevation and dense index of a compact TIN vertex
+struct CompactVertexInfo {
+  float z = 0;
+  std::uint32_t id = 0;
+};
+
+typedef CGAL::Triangulation_vertex_base_with_info_2<CompactVertexInfo, TIN_K>
+    COMPACT_Vb;
+typedef TinFaceBase<TIN_K> COMPACT_Fb;
+typedef CGAL::Triangulation_data_structure_2<COMPACT_Vb, COMPACT_Fb>
+    COMPACT_Tds;
+
+/**
+ * @brief TIN triangulating native 2D points, with each vertex's elevation
+ * stored as a float alongside a dense vertex index.
+ *
+ * Predicates run on the 2D kernel directly rather than projecting 3D points.
+ * Faces share the TinFaceBase of Tin, so path masks and tag IDs are kept when
+ * converting, and tagged features can be evaluated on either TIN.
+ */
+typedef CGAL::Constrained_Delaunay_triangulation_2<TIN_K, COMPACT_Tds, TIN_It>
+    CompactTin;
+
+typedef CompactTin::Vertex_handle CompactVertex_handle;
+typedef CompactTin::Face_handle CompactFace_handle;
+
+/// Position of a compact TIN vertex, with its elevation
+inline Point3 VertexPoint(const CompactVertex_handle &vertex) {
+  const auto &point = vertex->point();
+  return Point3(point.x(), point.y(), vertex->info().z);
+}
+
+/**
+ * @brief Copies the triangulation into a compact TIN, keeping its faces,
+ * constraints, path masks and tag IDs. Finite vertices are numbered densely
+ * from 0 in iteration order.
+ */
+CompactTin ConvertTinToCompactTin(const Tin &tin);
+
+/// Copies a compact TIN back into a Tin, keeping the same triangulation
+Tin ConvertCompactTinToTin(const CompactTin &compact_tin);
+
+} // namespace tsr
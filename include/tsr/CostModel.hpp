@@ -0,0 +1,263 @@
+#pragma once
+
+#include "tsr/Features/BoolWaterFeature.hpp"
+#include "tsr/Features/CEHTerrainFeature.hpp"
+#include "tsr/Features/GradientFeature.hpp"
+#include "tsr/Features/GradientSpeedFeature.hpp"
+#include "tsr/Features/PathFeature.hpp"
+#include "tsr/Logging.hpp"
+#include "tsr/PresetFeatures.hpp"
+#include "tsr/TsrState.hpp"
+
+#include <CGAL/Distance_3/Point_3_Point_3.h>
+
+#include <cmath>
+#include <limits>
+#include <ratio>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Compile-time composed cost functions.
+ *
+ * Each node is a small value type with a `value_type` typedef, a constructor
+ * taking the shared PresetFeatures, and a const `Calculate(State &)` over the
+ * search state of either TIN type, TsrState or CompactTsrState. Nodes
+ * are nested as template arguments, so a preset such as
+ *
+ *   Time<Distance, Inverse<Cond<Path, PathSpeed, Speed>>>
+ *
+ * compiles down to a single cost function without the virtual calls and
+ * dynamic_pointer_casts of the runtime FeatureManager graph. The node
+ * semantics match the equivalent runtime features, so both produce the same
+ * costs and warnings.
+ *
+ */
+namespace tsr::Cost {
+
+/// Traversed edge length
+struct Distance {
+  typedef double value_type;
+
+  explicit Distance(const PresetFeatures &) {}
+
+  template <typename State> double Calculate(State &state) const {
+    return std::sqrt(CGAL::squared_distance(VertexPoint(state.current_vertex),
+                                            VertexPoint(state.next_vertex)));
+  }
+};
+
+/// Traversed edge gradient
+struct Gradient {
+  typedef double value_type;
+
+  explicit Gradient(const PresetFeatures &) {}
+
+  template <typename State> double Calculate(State &state) const {
+    return GradientFeature::CalculateGradient(VertexPoint(state.current_vertex),
+                                              VertexPoint(state.next_vertex));
+  }
+};
+
+/// Constant value, given as a std::ratio so presets don't depend on floating
+/// point template parameters
+template <typename Value> struct Constant {
+  typedef double value_type;
+
+  static constexpr double value = static_cast<double>(Value::num) / Value::den;
+
+  explicit Constant(const PresetFeatures &) {}
+
+  template <typename State> double Calculate(State &) const { return value; }
+};
+
+/// Speed multiplier of the gradient X, using the shared gradient speed table
+template <typename X> class GradientSpeed {
+private:
+  X x;
+  const GradientSpeedFeature *feature;
+
+public:
+  typedef double value_type;
+
+  explicit GradientSpeed(const PresetFeatures &features)
+      : x(features), feature(features.gradient_speed.get()) {
+    if (feature == nullptr) {
+      TSR_LOG_ERROR("gradient speed feature not set");
+      throw std::runtime_error("gradient speed feature not set");
+    }
+  }
+
+  template <typename State> double Calculate(State &state) const {
+    return feature->CalculateSpeed(x.Calculate(state), state);
+  }
+};
+
+/**
+ * @brief Leaf node evaluating a data feature. CalculateFor is not virtual,
+ * and evaluates the feature on the search state of either TIN type.
+ *
+ */
+template <typename F> class FeatureNode {
+private:
+  F *feature;
+
+public:
+  typedef decltype(std::declval<F &>().CalculateFor(
+      std::declval<TsrState &>())) value_type;
+
+  explicit FeatureNode(F *feature) : feature(feature) {
+    if (feature == nullptr) {
+      TSR_LOG_ERROR("cost model feature not set");
+      throw std::runtime_error("cost model feature not set");
+    }
+  }
+
+  template <typename State> value_type Calculate(State &state) const {
+    return feature->CalculateFor(state);
+  }
+};
+
+struct Terrain : FeatureNode<CEHTerrainFeature> {
+  explicit Terrain(const PresetFeatures &features)
+      : FeatureNode(features.terrain.get()) {}
+};
+
+struct Water : FeatureNode<BoolWaterFeature> {
+  explicit Water(const PresetFeatures &features)
+      : FeatureNode(features.water.get()) {}
+};
+
+struct Path : FeatureNode<PathFeature> {
+  explicit Path(const PresetFeatures &features)
+      : FeatureNode(features.paths.get()) {}
+};
+
+/**
+ * @brief Multiplies its children in order, following MultiplierFeature: a
+ * false boolean child gives 0, an infinite child gives infinity, and
+ * evaluation stops once the product reaches 0.
+ *
+ */
+template <typename... Nodes> class Product {
+private:
+  std::tuple<Nodes...> nodes;
+
+  template <typename Node, typename State>
+  static bool Multiply(const Node &node, State &state, double &total) {
+    if constexpr (std::is_same_v<typename Node::value_type, bool>) {
+      if (!node.Calculate(state)) {
+        total = 0;
+      }
+    } else {
+      const double value = node.Calculate(state);
+
+      if (total == std::numeric_limits<double>::infinity() ||
+          value == std::numeric_limits<double>::infinity()) {
+        total = std::numeric_limits<double>::infinity();
+      } else {
+        total *= value;
+      }
+    }
+
+    return total != 0;
+  }
+
+public:
+  typedef double value_type;
+
+  explicit Product(const PresetFeatures &features)
+      : nodes(Nodes(features)...) {}
+
+  template <typename State> double Calculate(State &state) const {
+    double total = 1;
+    std::apply(
+        [&](const Nodes &...node) {
+          static_cast<void>((Multiply(node, state, total) && ...));
+        },
+        nodes);
+    return total;
+  }
+};
+
+/// Boolean negation, or the reciprocal of a double (infinite for 0)
+template <typename X> class Inverse {
+private:
+  X x;
+
+public:
+  typedef typename X::value_type value_type;
+
+  explicit Inverse(const PresetFeatures &features) : x(features) {}
+
+  template <typename State> value_type Calculate(State &state) const {
+    if constexpr (std::is_same_v<value_type, bool>) {
+      return !x.Calculate(state);
+    } else {
+      const double value = x.Calculate(state);
+
+      if (value == 0) {
+        return std::numeric_limits<double>::infinity();
+      }
+
+      return 1 / value;
+    }
+  }
+};
+
+/// Evaluates A if the condition holds, otherwise B
+template <typename C, typename A, typename B> class Cond {
+private:
+  C condition;
+  A a;
+  B b;
+
+  static_assert(std::is_same_v<typename C::value_type, bool>,
+                "condition node must be boolean");
+  static_assert(std::is_same_v<typename A::value_type, typename B::value_type>,
+                "conditional branches must have the same type");
+
+public:
+  typedef typename A::value_type value_type;
+
+  explicit Cond(const PresetFeatures &features)
+      : condition(features), a(features), b(features) {}
+
+  template <typename State> value_type Calculate(State &state) const {
+    if (condition.Calculate(state)) {
+      return a.Calculate(state);
+    } else {
+      return b.Calculate(state);
+    }
+  }
+};
+
+/// Traversal time of an edge, given its distance and inverse speed
+template <typename D, typename InverseSpeed>
+using Time = Product<D, InverseSpeed>;
+
+/*
+ * Built-in presets, equivalent to the graphs built in Presets.cpp
+ */
+
+using PathSpeed = Product<GradientSpeed<Gradient>>;
+
+using Speed = Product<Inverse<Water>, Terrain, GradientSpeed<Gradient>>;
+
+template <typename SwimSpeed>
+using SwimmingSpeed =
+    Product<Cond<Water, Constant<SwimSpeed>, Constant<std::ratio<1>>>, Terrain,
+            GradientSpeed<Gradient>>;
+
+using TimePreset = Time<Distance, Inverse<Cond<Path, PathSpeed, Speed>>>;
+
+using TimeWithSwimmingPreset =
+    Time<Distance,
+         Inverse<Cond<Path, PathSpeed, SwimmingSpeed<std::ratio<89, 100>>>>>;
+
+using TimeRestrictSwimmingPreset =
+    Time<Distance, Inverse<Cond<Path, PathSpeed, SwimmingSpeed<std::milli>>>>;
+
+} // namespace tsr::Cost
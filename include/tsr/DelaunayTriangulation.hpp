@@ -1,10 +1,17 @@
 #pragma once
 
+#include "tsr/ChunkInfo.hpp"
 #include "tsr/MeshBoundary.hpp"
+#include "tsr/Point2.hpp"
 #include "tsr/Point3.hpp"
 #include "tsr/SurfaceMesh.hpp"
 #include "tsr/Tin.hpp"
+#include "tsr/TinBuilder.hpp"
+#include <cstddef>
+#include <functional>
+#include <set>
 #include <utility>
+#include <vector>
 
 namespace tsr {
 
@@ -13,11 +20,51 @@ namespace tsr {
 #define DEFAULT_COSINE_MAX_ANGLE_CORNERS 0.9
 #define DEFAULT_MAX_DISTANCE_CORNERS 3.0
 
+#define DEFAULT_DEM_URL_FORMAT                                                 \
+  "https://portal.opentopography.org/API/"                                     \
+  "globaldem?demtype=COP30&south={}&west={}&north={}"                          \
+  "&east={}&outputFormat=GeoTiff&API_Key={}"
+
+/**
+ * @brief Bounds on the DEM chunks processed at once, which bound the memory
+ * used by their rasters.
+ *
+ * Each chunk's raster is released as soon as its TIN is built. The finished
+ * chunk TINs are not covered by these bounds: every one is held until they
+ * are stitched, so they grow with the number of chunks the boundary covers.
+ * They are error bounded, so are far smaller than the rasters they replace.
+ */
+struct ChunkPipelineOptions {
+  /// Maximum number of chunk rasters fetched or loaded from the cache at once
+  std::size_t max_concurrent_fetches = 4;
+
+  /// Maximum number of chunks between being fetched and their TIN being
+  /// collected, so at most this many rasters are held in memory
+  std::size_t max_chunks_in_flight = 8;
+};
+
+/// Whether a DEM chunk is built into the TIN
+typedef std::function<bool(const ChunkInfo &)> ChunkFilter;
+
+/**
+ * @brief Builds the TIN of the DEM chunks covering the boundary, clipped to
+ * the boundary. Chunks rejected by the filter are skipped, for example those
+ * already in a TIN being grown, which may leave the TIN empty.
+ */
 Tin InitializeTinFromBoundary(
     MeshBoundary boundary, std::string api_key,
-    std::string url_format = "https://portal.opentopography.org/API/"
-                             "globaldem?demtype=COP30&south={}&west={}&north={}"
-                             "&east={}&outputFormat=GeoTiff&API_Key={}");
+    std::string url_format = DEFAULT_DEM_URL_FORMAT,
+    const TinBuilderOptions &options = TinBuilderOptions(),
+    const ChunkPipelineOptions &pipeline_options = ChunkPipelineOptions(),
+    const ChunkFilter &chunk_filter = ChunkFilter());
+
+/**
+ * @brief Inserts the points into the TIN in one batch. Points sharing an XY
+ * position are removed, keeping the first, and the rest are inserted in
+ * Hilbert order, so each insertion only walks a short way from the last.
+ * Reorders the points.
+ */
+void InsertPoints(Tin &tin, std::vector<Point3> &points);
 
 void MergeTinPointsInBoundary(MeshBoundary &boundary, const Tin &srcTIN,
                               Tin &dstTIN);
@@ -31,14 +78,47 @@ void ConvertSurfaceMeshToTin(SurfaceMesh const &source, Tin &target);
 
 void ConvertTinToSurfaceMesh(Tin const &source, SurfaceMesh &target);
 
+/**
+ * @brief Removes vertices which barely change the surface, directly from the
+ * triangulation. A vertex is removed if its incident faces are within the
+ * maximum angle of their mean normal, and it is within the maximum distance
+ * of its neighbours' plane. Hull vertices use the corner thresholds. Vertices
+ * within a centimetre of a neighbour are always removed, and constrained
+ * vertices always kept. The source and target may be the same TIN.
+ *
+ * InitializeTinFromBoundary calls it with zero thresholds, to remove the near
+ * duplicates along chunk seams without changing the surface.
+ */
 void SimplifyTin(Tin const &source_mesh, Tin &target_mesh,
                  float cosine_max_angle_regions, float max_distance_regions,
                  float cosine_max_angle_corners, float max_distance_corners);
 
 void SimplifyTin(Tin const &source_mesh, Tin &target_mesh);
 
+/**
+ * @brief Interpolates the constraint segments of a contour onto the TIN
+ * surface, splitting segments longer than the maximum length. Segments with
+ * an end outside the TIN are skipped. The TIN is not modified.
+ *
+ * Points are located by walking from the hint, which is updated to the face
+ * of the last located point, so consecutive contours can share the walk.
+ */
+void CollectContourConstraints(
+    const Tin &tin, const std::vector<Point2> &contour,
+    double max_segment_length,
+    std::vector<std::pair<Point3, Point3>> &constraints, Face_handle &hint);
+
+/**
+ * @brief Adds the constraints of every contour to the TIN in a single bulk
+ * insertion, returning the inserted segments.
+ */
+std::vector<std::pair<Point3, Point3>>
+AddContourConstraints(Tin &tin,
+                      const std::vector<std::vector<Point2>> &contours,
+                      double max_segment_length);
+
 std::set<std::pair<Point3, Point3>>
-AddContourConstraint(Tin &tin, std::vector<Point2> contour,
+AddContourConstraint(Tin &tin, const std::vector<Point2> &contour,
                      double max_segment_length);
 
 } // namespace tsr
\ No newline at end of file
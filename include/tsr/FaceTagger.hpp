@@ -0,0 +1,80 @@
+#pragma once
+
+#include "tsr/Features/RasterFeature.hpp"
+#include "tsr/TileCache.hpp"
+#include "tsr/Tin.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace tsr {
+
+/**
+ * @brief Numbers the finite faces of the TIN with consecutive tag IDs in
+ * Hilbert curve order, returning the faces in tag ID order. Tags are
+ * invalidated by any change to the TIN's faces.
+ *
+ */
+std::vector<Face_handle> AssignFaceTagIds(const Tin &tin);
+
+/**
+ * @brief Signature of the vertex IDs of a face, independent of their order.
+ * A face whose signature differs from the one it was tagged with has been
+ * changed since, for example flipped by a constraint insertion.
+ *
+ */
+std::uint32_t CalculateFaceSignature(Face_handle face);
+
+/**
+ * @brief Tags the TIN faces for a set of raster features in a single pass.
+ * Each face's sample point and its WGS84 position are computed once, and
+ * dispatched to every registered feature.
+ *
+ * Faces are tagged in parallel ranges of spatially ordered faces, sharing
+ * read-only raster tiles between threads through an LRU tile cache.
+ * Features write each face's tag to a preallocated slot indexed by its tag
+ * ID, so TagFace may be called concurrently.
+ *
+ */
+class FaceTagger {
+private:
+  std::vector<RasterFeature *> features;
+
+  bool parallel = true;
+
+  std::shared_ptr<TileCache> tile_cache = std::make_shared<TileCache>();
+
+  /// Renumbers and tags every face, discarding existing tags
+  std::vector<Face_handle> TagAll(const Tin &tin) const;
+
+  /// Tags the given faces, with tag IDs below the tag count
+  void TagFaces(const std::vector<Face_handle> &faces,
+                std::size_t tag_count) const;
+
+public:
+  /// Registers a feature to tag. The feature must outlive the tagger.
+  void AddFeature(RasterFeature &feature);
+
+  void SetParallel(bool parallel) { this->parallel = parallel; }
+
+  /// Shares a tile cache, for example between repeated tagging passes
+  void SetTileCache(std::shared_ptr<TileCache> tile_cache) {
+    this->tile_cache = tile_cache;
+  }
+
+  void Tag(const Tin &tin) const;
+
+  /**
+   * @brief Tags only the faces created or changed since the TIN was last
+   * tagged, for example by inserting the constraints of another feature.
+   * New faces are given tag IDs after the existing ones. Falls back to
+   * tagging every face once removed faces leave too many unused tag IDs.
+   *
+   * @return The faces which were tagged
+   */
+  std::vector<Face_handle> Retag(const Tin &tin) const;
+};
+
+} // namespace tsr
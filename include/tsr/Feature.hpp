@@ -3,10 +3,12 @@
 #include <boost/concept_check.hpp>
 #include <gdal/gdal_priv.h>
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "tsr/FeatureProfile.hpp"
 #include "tsr/MeshBoundary.hpp"
 #include "tsr/Tin.hpp"
 #include "tsr/TsrState.hpp"
@@ -22,6 +24,11 @@ public:
   /// Stores the feature dependencies
   std::vector<std::shared_ptr<FeatureBase>> dependencies;
 
+#ifdef TSR_PROFILE_FEATURES
+  /// Accumulated over every graph the feature is part of
+  FeatureProfile profile;
+#endif
+
   /// Features can override or re-define with their own initialization functions
   FeatureBase(const std::string &feature_id) : feature_id(feature_id) {}
 
@@ -36,8 +43,38 @@ public:
   /// Adds a dependency to the feature, ensuring access to those features
   virtual void AddDependency(std::shared_ptr<FeatureBase> feature);
 
-  static void AddWarning(TsrState &state, const std::string &warning,
-                         const unsigned short priority);
+  /// Adds a warning to the state's current face, unless it already has a
+  /// higher priority warning
+  template <typename State>
+  static void AddWarning(State &state, const std::string &warning,
+                         const unsigned short priority) {
+
+    auto face = state.current_face;
+
+    if (state.warnings.contains(face)) {
+      size_t existingIndex = state.warnings[face];
+      const unsigned short existingPriority =
+          state.warning_priorities[existingIndex];
+
+      if (existingPriority > priority) {
+        return;
+      }
+    }
+
+    // Either no warning already exists, or the new priority is higher than old
+    size_t newIndex = state.AddWarning(warning, priority);
+
+    state.warnings[face] = newIndex;
+  }
+
+  /// Records whether a data lookup found a value, when profiling is enabled
+  void RecordLookup(bool hit) {
+#ifdef TSR_PROFILE_FEATURES
+    this->profile.RecordLookup(hit);
+#else
+    boost::ignore_unused_variable_warning(hit);
+#endif
+  }
 };
 
 template <typename DataType> class Feature : public FeatureBase {
@@ -57,6 +94,15 @@ public:
 
   // Features must implement their own calculate logic
   virtual DataType Calculate(TsrState &state) = 0;
+
+  /// Calculates the feature value, timing the call when profiling is enabled.
+  /// Dependencies should be evaluated through this rather than Calculate.
+  DataType Evaluate(TsrState &state) {
+#ifdef TSR_PROFILE_FEATURES
+    FeatureProfileScope scope(this->profile);
+#endif
+    return this->Calculate(state);
+  }
 };
 
 } // namespace tsr
\ No newline at end of file
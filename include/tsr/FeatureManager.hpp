@@ -1,8 +1,12 @@
 #pragma once
 #include "tsr/Feature.hpp"
+#include "tsr/FeatureProfile.hpp"
 #include "tsr/TsrState.hpp"
 
 #include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 namespace tsr {
 
@@ -24,6 +28,12 @@ public:
   bool HasDependencyCycle() const;
 
   double Calculate(TsrState &state) const;
+
+  /// Profile of each feature in the graph. Empty unless built with
+  /// TSR_PROFILE_FEATURES.
+  std::vector<FeatureProfileEntry> GetProfile() const;
+
+  void ResetProfile() const;
 };
 
 } // namespace tsr
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tsr {
+
+/**
+ * @brief Call timing and lookup statistics of a single feature. Only
+ * recorded when built with TSR_PROFILE_FEATURES.
+ *
+ */
+struct FeatureProfile {
+  static constexpr std::size_t HISTOGRAM_BUCKETS = 64;
+
+  std::uint64_t calls = 0;
+
+  /// Time spent in the feature, including its dependencies
+  std::uint64_t total_ns = 0;
+
+  /// Time spent in the feature, excluding its dependencies
+  std::uint64_t self_ns = 0;
+
+  /// Tag lookups for data features, and how many found a tagged face
+  std::uint64_t lookups = 0;
+  std::uint64_t lookup_hits = 0;
+
+  /// Call durations, bucketed by the bit width of their nanosecond count
+  std::array<std::uint64_t, HISTOGRAM_BUCKETS> histogram = {};
+
+  void RecordCall(std::uint64_t call_total_ns, std::uint64_t call_self_ns);
+
+  void RecordLookup(bool hit) {
+    lookups++;
+    if (hit) {
+      lookup_hits++;
+    }
+  }
+
+  /// Approximate call duration at the given percentile [0, 1], rounded up to
+  /// the next power of two nanoseconds
+  std::uint64_t Percentile(double percentile) const;
+
+  /// Fraction of tag lookups which found a tagged face
+  double TagLookupHitRate() const;
+
+  void Reset() { *this = FeatureProfile(); }
+};
+
+/**
+ * @brief Times a feature calculation for its lifetime. Scopes nest per
+ * thread, so time spent in dependencies is excluded from the parent's self
+ * time.
+ *
+ */
+class FeatureProfileScope {
+private:
+  FeatureProfile &profile;
+  FeatureProfileScope *parent;
+  std::chrono::steady_clock::time_point start;
+  std::uint64_t child_ns = 0;
+
+  static inline thread_local FeatureProfileScope *current = nullptr;
+
+public:
+  explicit FeatureProfileScope(FeatureProfile &profile)
+      : profile(profile), parent(current),
+        start(std::chrono::steady_clock::now()) {
+    current = this;
+  }
+
+  ~FeatureProfileScope() {
+    const std::uint64_t elapsed =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+
+    const std::uint64_t self = elapsed > child_ns ? elapsed - child_ns : 0;
+    profile.RecordCall(elapsed, self);
+
+    if (parent != nullptr) {
+      parent->child_ns += elapsed;
+    }
+    current = parent;
+  }
+
+  FeatureProfileScope(const FeatureProfileScope &) = delete;
+  FeatureProfileScope &operator=(const FeatureProfileScope &) = delete;
+};
+
+struct FeatureProfileEntry {
+  std::string feature_id;
+  FeatureProfile profile;
+};
+
+/// Formats the profile as a text table, ordered by descending self time
+std::string FormatFeatureProfileTable(std::vector<FeatureProfileEntry> entries);
+
+/// Formats the profile as a JSON array, ordered by descending self time
+std::string FormatFeatureProfileJson(std::vector<FeatureProfileEntry> entries);
+
+} // namespace tsr
@@ -1,17 +1,24 @@
 #pragma once
 
+#include "tsr/ChunkInfo.hpp"
 #include "tsr/Features/DataFeature.hpp"
+#include "tsr/Features/RasterFeature.hpp"
 #include "tsr/MeshBoundary.hpp"
+#include "tsr/Point2.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/RasterTile.hpp"
 #include "tsr/Tin.hpp"
 
 #include "tsr/TsrState.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 namespace tsr {
 
-class BoolWaterFeature : public DataFeature<bool> {
+class BoolWaterFeature : public DataFeature<bool>, public RasterFeature {
 
 private:
   enum DEPENDENCIES { DISTANCE };
@@ -20,20 +27,57 @@ private:
   inline static int NODATA_VALUE = -9999;
   enum WATER_STATUS { NODATA, WATER, LAND };
 
-  std::unordered_map<Face_handle, WATER_STATUS> waterMap;
+  /// Water status of each face, indexed by the face tag ID
+  std::vector<WATER_STATUS> water_tags;
+
+  /// Fetches or loads the contours of a single chunk
+  std::vector<std::vector<Point2>> PrepareChunk(const ChunkInfo &chunk) const;
 
 public:
   BoolWaterFeature(std::string name, double tile_size)
       : DataFeature(name, URL, tile_size,
                     {0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3}) {};
 
-  void Initialize(Tin &tin, const MeshBoundary &boundary) override;
+  void PrepareData(const MeshBoundary &boundary) override;
+
+  void AddConstraints(Tin &tin) override;
 
   void Tag(const Tin &tin) override;
 
+  std::string GetRasterCacheID() const override;
+
+  const ChunkManager &GetRasterChunkManager() const override {
+    return this->chunkManager;
+  }
+
+  GDALDataType GetRasterDataType() const override { return GDT_Float32; }
+
+  void ResizeTags(std::size_t face_count) override {
+    this->water_tags.resize(face_count, NODATA);
+  }
+
+  std::vector<std::uint8_t> ExportTags() const override {
+    return std::vector<std::uint8_t>(this->water_tags.begin(),
+                                     this->water_tags.end());
+  }
+
+  void ImportTags(const std::uint8_t *tags, std::size_t count) override {
+    this->water_tags.resize(count);
+    for (std::size_t i = 0; i < count; i++) {
+      this->water_tags[i] = static_cast<WATER_STATUS>(tags[i]);
+    }
+  }
+
+  void TagFace(Face_handle face, const Point3 &sample,
+               const RasterTile *tile) override;
+
   bool Calculate(TsrState &state) override;
 
-  void WriteWaterToKml();
+  /// Calculates on the search state of either TIN type, as compact TINs keep
+  /// the face data. Defined for TsrState and CompactTsrState.
+  template <typename State> bool CalculateFor(State &state);
+
+  void WriteWaterToKml(const Tin &tin) const;
 };
 
 } // namespace tsr
\ No newline at end of file
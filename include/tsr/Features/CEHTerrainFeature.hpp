@@ -1,13 +1,19 @@
+#pragma once
+
+#include "tsr/ChunkInfo.hpp"
 #include "tsr/Features/DataFeature.hpp"
+#include "tsr/Features/RasterFeature.hpp"
 #include "tsr/MeshBoundary.hpp"
+#include "tsr/Point2.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/RasterTile.hpp"
 #include "tsr/Tin.hpp"
 #include "tsr/TsrState.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <gdal/gdal.h>
-#include <map>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 namespace tsr {
@@ -33,26 +39,66 @@ enum CEH_TERRAIN_TYPE {
   NO_DATA
 };
 
-class CEHTerrainFeature : public DataFeature<double> {
+class CEHTerrainFeature : public DataFeature<double>,
+                          public RasterFeature {
 private:
-  static std::map<uint32_t, CEH_TERRAIN_TYPE> TERRAIN_COLOURS;
+  /// Terrain type of each face, indexed by the face tag ID
+  std::vector<CEH_TERRAIN_TYPE> terrain_tags;
 
-  std::unordered_map<Face_handle, CEH_TERRAIN_TYPE> terrain_map;
+  static std::string URL;
 
-  static CEH_TERRAIN_TYPE
-  interpretCEHTerrainColour(std::vector<double> colourValues);
+  /**
+   * @brief Converts an RGB terrain dataset into a single band dataset of
+   * CEH_TERRAIN_TYPE class codes, and caches it. Tagging then reads one byte
+   * per sample rather than decoding three colour bands.
+   */
+  void CacheClassRaster(const std::string &cache_id, const ChunkInfo &chunk,
+                        GDALDatasetH rgb_dataset) const;
 
-  static std::vector<double> GetPixelColour(GDALDatasetH dataset, int x, int y);
-  static std::string URL;
+  /// Fetches or loads the contours of a single chunk
+  std::vector<std::vector<Point2>> PrepareChunk(const ChunkInfo &chunk) const;
 
 public:
   CEHTerrainFeature(std::string name, double tile_size)
       : DataFeature(name, URL, tile_size, {1, 0, 3, 2}) {};
 
-  void Initialize(Tin &tin, const MeshBoundary &boundary) override;
+  void PrepareData(const MeshBoundary &boundary) override;
+
+  void AddConstraints(Tin &tin) override;
 
   void Tag(const Tin &tin) override;
 
+  std::string GetRasterCacheID() const override;
+
+  const ChunkManager &GetRasterChunkManager() const override {
+    return this->chunkManager;
+  }
+
+  GDALDataType GetRasterDataType() const override { return GDT_Byte; }
+
+  void ResizeTags(std::size_t face_count) override {
+    this->terrain_tags.resize(face_count, CEH_TERRAIN_TYPE::NO_DATA);
+  }
+
+  std::vector<std::uint8_t> ExportTags() const override {
+    return std::vector<std::uint8_t>(this->terrain_tags.begin(),
+                                     this->terrain_tags.end());
+  }
+
+  void ImportTags(const std::uint8_t *tags, std::size_t count) override {
+    this->terrain_tags.resize(count);
+    for (std::size_t i = 0; i < count; i++) {
+      this->terrain_tags[i] = static_cast<CEH_TERRAIN_TYPE>(tags[i]);
+    }
+  }
+
+  void TagFace(Face_handle face, const Point3 &sample,
+               const RasterTile *tile) override;
+
   double Calculate(TsrState &state) override;
+
+  /// Calculates on the search state of either TIN type, as compact TINs keep
+  /// the face data. Defined for TsrState and CompactTsrState.
+  template <typename State> double CalculateFor(State &state);
 };
 } // namespace tsr
\ No newline at end of file
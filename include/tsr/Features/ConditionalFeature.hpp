@@ -1,3 +1,5 @@
+#pragma once
+
 #include "tsr/Feature.hpp"
 #include "tsr/TsrState.hpp"
 #include <memory>
@@ -17,14 +19,14 @@ public:
     auto conditionalFeature = std::dynamic_pointer_cast<Feature<bool>>(
         this->dependencies[CONDITIONAL]);
 
-    if (conditionalFeature->Calculate(state)) {
+    if (conditionalFeature->Evaluate(state)) {
       auto feature =
           std::dynamic_pointer_cast<Feature<double>>(this->dependencies[A]);
-      return feature->Calculate(state);
+      return feature->Evaluate(state);
     } else {
       auto feature =
           std::dynamic_pointer_cast<Feature<double>>(this->dependencies[B]);
-      return feature->Calculate(state);
+      return feature->Evaluate(state);
     }
   }
 };
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "tsr/Feature.hpp"
 #include "tsr/TsrState.hpp"
 #include <boost/concept_check.hpp>
@@ -1,15 +1,84 @@
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <string>
 #include <vector>
 
+#include "tsr/ChunkInfo.hpp"
 #include "tsr/ChunkManager.hpp"
 #include "tsr/Feature.hpp"
+#include "tsr/MeshBoundary.hpp"
+#include "tsr/Point2.hpp"
+#include "tsr/Tin.hpp"
 #include "tsr/TsrState.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 namespace tsr {
 
+/**
+ * @brief Feature backed by chunked API data.
+ *
+ * Initialization is split into two phases. PrepareData fetches and processes
+ * the data without touching the mesh, so may run concurrently with other
+ * features. AddConstraints then inserts the prepared data into the mesh, and
+ * must be run serially.
+ */
 template <typename DataType> class DataFeature : public Feature<DataType> {
+protected:
+  /// Contours prepared for insertion into the mesh
+  std::vector<std::vector<Point2>> prepared_contours;
+
+  /// Regions whose data is already in the mesh, so is not prepared again
+  std::vector<MeshBoundary> excluded_regions;
+
+  /**
+   * @brief Clips the contours of the prepared chunks to the boundary, leaving
+   * out the parts in excluded regions.
+   *
+   * Excluded regions are subtracted in order from the unclipped contours, as
+   * they were when each region was prepared, so the pieces meet the
+   * constraints already in the mesh at exactly the same points.
+   */
+  std::vector<std::vector<Point2>>
+  ClipPreparedContours(const MeshBoundary &boundary,
+                       std::vector<std::vector<Point2>> contours) const {
+    for (const MeshBoundary &region : this->excluded_regions) {
+      contours = region.SubtractContours(contours);
+    }
+    return boundary.ClipContours(contours);
+  }
+
+  /**
+   * @brief Prepares each chunk in parallel, returning the contours of every
+   * chunk in chunk order.
+   */
+  template <typename PrepareChunk>
+  std::vector<std::vector<Point2>>
+  PrepareChunks(const std::vector<ChunkInfo> &chunks,
+                PrepareChunk prepareChunk) const {
+
+    std::vector<std::vector<std::vector<Point2>>> chunkContours(chunks.size());
+
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, chunks.size()),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                        for (std::size_t i = range.begin(); i != range.end();
+                             i++) {
+                          chunkContours[i] = prepareChunk(chunks[i]);
+                        }
+                      });
+
+    std::vector<std::vector<Point2>> contours;
+    for (auto &chunk : chunkContours) {
+      contours.insert(contours.end(), std::make_move_iterator(chunk.begin()),
+                      std::make_move_iterator(chunk.end()));
+    }
+
+    return contours;
+  }
+
 public:
   /// Raster API
   ChunkManager chunkManager;
@@ -23,7 +92,23 @@ public:
               std::vector<int> position_order)
       : DataFeature(name, url, tile_size, position_order, "") {}
 
+  /// Leaves the data inside the regions out of later calls to PrepareData
+  void ExcludeRegions(const std::vector<MeshBoundary> &regions) {
+    this->excluded_regions = regions;
+  }
+
+  /// Fetches and processes the data covering the boundary
+  virtual void PrepareData(const MeshBoundary &boundary) = 0;
+
+  /// Inserts the prepared data into the mesh
+  virtual void AddConstraints(Tin &tin) = 0;
+
+  void Initialize(Tin &tin, const MeshBoundary &boundary) override {
+    PrepareData(boundary);
+    AddConstraints(tin);
+  }
+
   virtual DataType Calculate(TsrState &state) override = 0;
 };
 
-} // namespace tsr
\ No newline at end of file
+} // namespace tsr
@@ -1,39 +1,66 @@
 #pragma once
 
-#include "tsr/Feature.hpp"
+#include "tsr/Features/TabulatedFeature.hpp"
 #include "tsr/TsrState.hpp"
 
+#include <cmath>
 #include <string>
 #include <vector>
 
 namespace tsr {
 
-class GradientSpeedFeature : public Feature<double> {
+/**
+ * @brief Speed multiplier for a given gradient, using separate polynomial
+ * response curves for upward and downward gradients. The curves are tabulated
+ * over the gradient range [-1, 1] when the feature is constructed.
+ *
+ */
+class GradientSpeedFeature : public TabulatedFeature {
 private:
-  std::vector<double> upwards_coefficients;
-  std::vector<double> downwards_coefficients;
-
-  enum DEPENDENCIES { X };
-
   static inline std::vector<double> DEFAULT_UPWARDS_COEFFS = {1, -2.7, -34.83,
                                                               200.63, -292.06};
   static inline std::vector<double> DEFAULT_DOWNWARDS_COEFFS = {
       1, -0.01, 79.31, 1164.83, 4622.34, 5737.68};
 
+  static inline double MIN_GRADIENT = -1;
+  static inline double MAX_GRADIENT = 1;
+
 public:
   GradientSpeedFeature(std::string name,
                        std::vector<double> upwards_coefficients,
                        std::vector<double> downwards_coefficients)
-      : Feature<double>(name), upwards_coefficients(upwards_coefficients),
-        downwards_coefficients(downwards_coefficients) {};
+      : TabulatedFeature(name,
+                         Piecewise({{0, Polynomial(downwards_coefficients)},
+                                    {MAX_GRADIENT,
+                                     Polynomial(upwards_coefficients)}}),
+                         MIN_GRADIENT, MAX_GRADIENT) {}
 
   GradientSpeedFeature(std::string name)
       : GradientSpeedFeature(name, DEFAULT_UPWARDS_COEFFS,
                              DEFAULT_DOWNWARDS_COEFFS) {}
 
-  static double SolvePolynomial(double x, std::vector<double> &coefficients);
+  /// Speed multiplier of a gradient, warning on the state's current face of
+  /// either TIN type
+  template <typename State>
+  double CalculateSpeed(double gradient, State &state) const {
+
+    double speedInfluence = Lookup(gradient);
+
+    // Cap the speedInfluence to a minimum of 0x speed
+    double cappedSpeedInfluence = fmax(0.0, speedInfluence);
+
+    if (cappedSpeedInfluence <= 0) {
+      AddWarning(state, "Untraversable gradient", 10);
+    } else if (cappedSpeedInfluence < 0.5) {
+      AddWarning(state, "Steep Gradient", 2);
+    } else if (cappedSpeedInfluence < 0.8) {
+      AddWarning(state, "Slight Gradient", 1);
+    }
+
+    return cappedSpeedInfluence;
+  }
 
   double Calculate(TsrState &state) override;
 };
 
-}; // namespace tsr
\ No newline at end of file
+}; // namespace tsr
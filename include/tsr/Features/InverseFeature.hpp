@@ -1,3 +1,5 @@
+#pragma once
+
 #include "tsr/Feature.hpp"
 #include "tsr/TsrState.hpp"
 
@@ -20,13 +22,13 @@ public:
 template <> inline bool InverseFeature<bool, bool>::Calculate(TsrState &state) {
   auto feature =
       std::dynamic_pointer_cast<Feature<bool>>(this->dependencies[VALUE]);
-  return !feature->Calculate(state);
+  return !feature->Evaluate(state);
 }
 template <>
 inline double InverseFeature<bool, double>::Calculate(TsrState &state) {
   auto feature =
       std::dynamic_pointer_cast<Feature<bool>>(this->dependencies[VALUE]);
-  if (!feature->Calculate(state)) {
+  if (!feature->Evaluate(state)) {
     return 1;
   } else {
     return std::numeric_limits<double>::infinity();
@@ -39,7 +41,7 @@ inline double InverseFeature<double, double>::Calculate(TsrState &state) {
   auto feature =
       std::dynamic_pointer_cast<Feature<double>>(this->dependencies[VALUE]);
 
-  double value = feature->Calculate(state);
+  double value = feature->Evaluate(state);
 
   if (value == 0) {
     return std::numeric_limits<double>::infinity();
@@ -1,48 +1,74 @@
 #pragma once
 
+#include "tsr/ChunkInfo.hpp"
 #include "tsr/Features/DataFeature.hpp"
-#include "tsr/IO/FileIO.hpp"
 #include "tsr/MeshBoundary.hpp"
+#include "tsr/Point2.hpp"
 #include "tsr/Point3.hpp"
 #include "tsr/Tin.hpp"
 #include "tsr/TsrState.hpp"
 #include <cstddef>
 #include <string>
-#include <unordered_set>
 #include <utility>
-
-#include "tsr/IO/KMLWriter.hpp"
+#include <vector>
 
 namespace tsr {
 
-struct EdgeHash {
-  std::size_t operator()(const std::pair<Point3, Point3> &edge) const;
-};
-
+/**
+ * @brief Marks edges of the TIN which lie along a path. Path membership is
+ * stored directly on the TIN faces as an edge mask, so lookups during routing
+ * are constant time.
+ */
 class PathFeature : public DataFeature<bool> {
 private:
-  std::unordered_set<std::pair<Point3, Point3>, EdgeHash> paths;
+  /// Path constraint segments inserted during initialization, marked onto
+  /// the TIN edges when tagging
+  std::vector<std::pair<Point3, Point3>> path_segments;
 
   static std::string URL;
 
-  std::pair<Point3, Point3> NormalizeSegmentOrder(Point3 p1, Point3 p2);
+  static void MarkPathEdge(const Tin &tin, Face_handle face, int index);
+
+  /// Marks the edges a path segment was inserted along, starting the
+  /// search from the hint and leaving it at the segment's target
+  static size_t MarkPathSegment(const Tin &tin,
+                                const std::pair<Point3, Point3> &segment,
+                                Face_handle &hint);
+
+  /// Fetches or loads the contours of a single chunk
+  std::vector<std::vector<Point2>> PrepareChunk(const ChunkInfo &chunk) const;
 
 public:
   PathFeature(std::string name, double tile_size)
       : DataFeature(name, URL, tile_size, {0, 1, 2, 3}) {}
 
-  void Initialize(Tin &tin, const MeshBoundary &boundary) override;
+  void PrepareData(const MeshBoundary &boundary) override;
+
+  void AddConstraints(Tin &tin) override;
+
+  void Tag(const Tin &tin) override;
+
+  /// Re-marks the paths after the given faces were created or changed, as
+  /// their edge masks no longer match their edges. Only the segments near
+  /// the changed faces are located again.
+  void Retag(const Tin &tin, const std::vector<Face_handle> &changed_faces);
+
   bool Calculate(TsrState &state) override;
 
-  void WritePathsToKml() {
-    std::string kml = "";
+  /// Calculates on the search state of either TIN type, as compact TINs keep
+  /// the face data. Defined for TsrState and CompactTsrState.
+  template <typename State> bool CalculateFor(State &state);
 
-    for (auto path : this->paths) {
-      kml += IO::GenerateKmlLine(path);
-    }
+  const std::vector<std::pair<Point3, Point3>> &GetPathSegments() const {
+    return this->path_segments;
+  }
 
-    IO::WriteDataToFile("path.kml", IO::GenerateKmlDocument(kml));
+  /// Replaces the segments marked onto the TIN, for example by a snapshot's
+  void SetPathSegments(std::vector<std::pair<Point3, Point3>> path_segments) {
+    this->path_segments = std::move(path_segments);
   }
+
+  void WritePathsToKml(const Tin &tin) const;
 };
 
-} // namespace tsr
\ No newline at end of file
+} // namespace tsr
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "tsr/ChunkManager.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/RasterTile.hpp"
+#include "tsr/Tin.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <gdal/gdal.h>
+#include <string>
+#include <vector>
+
+namespace tsr {
+
+/**
+ * @brief Interface of features which tag TIN faces by sampling cached raster
+ * tiles. Tagging is driven by a FaceTagger, which visits each face once for
+ * all registered raster features.
+ *
+ */
+class RasterFeature {
+public:
+  virtual ~RasterFeature() = default;
+
+  /// Cache ID of the raster tiles sampled when tagging
+  virtual std::string GetRasterCacheID() const = 0;
+
+  /// Resolves the raster tile covering a WGS84 point
+  virtual const ChunkManager &GetRasterChunkManager() const = 0;
+
+  /// Type the raster bands are loaded as
+  virtual GDALDataType GetRasterDataType() const = 0;
+
+  /// Resizes the tag slots to the number of face tag IDs, keeping existing
+  /// tags. New slots are untagged.
+  virtual void ResizeTags(std::size_t face_count) = 0;
+
+  /// Tag of each slot as a byte, for writing to snapshots
+  virtual std::vector<std::uint8_t> ExportTags() const = 0;
+
+  /// Replaces the tags with those exported to a snapshot
+  virtual void ImportTags(const std::uint8_t *tags, std::size_t count) = 0;
+
+  /// Tags a face given its UTM sample point, and the raster tile covering it,
+  /// which is nullptr if the tile is not cached. May be called concurrently
+  /// for different faces.
+  virtual void TagFace(Face_handle face, const Point3 &sample,
+                       const RasterTile *tile) = 0;
+};
+
+} // namespace tsr
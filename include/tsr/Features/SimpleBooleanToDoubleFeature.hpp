@@ -24,7 +24,7 @@ public:
 
     auto boolFeature = std::dynamic_pointer_cast<SimpleBooleanFeature>(
         this->dependencies.at(DEPENDENCIES::SIMPLE_BOOLEAN));
-    bool boolValue = boolFeature->Calculate(state);
+    bool boolValue = boolFeature->Evaluate(state);
 
     return boolValue ? this->pos_value : this->neg_value;
   }
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "tsr/Feature.hpp"
+#include "tsr/TsrState.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tsr {
+
+/**
+ * @brief Samples a 1D response curve of its dependency into a lookup table
+ * when constructed, so that each calculation costs a single linearly
+ * interpolated table lookup. Inputs outside the sampled range are clamped to
+ * the ends of the range.
+ *
+ */
+class TabulatedFeature : public Feature<double> {
+protected:
+  enum DEPENDENCIES { X };
+
+private:
+  double min_x;
+  double max_x;
+  double inverse_step;
+
+  std::vector<double> table;
+
+public:
+  typedef std::function<double(double)> Curve;
+
+  static inline std::size_t DEFAULT_SAMPLES = 4096;
+
+  TabulatedFeature(std::string name, Curve curve, double min_x, double max_x,
+                   std::size_t samples);
+
+  TabulatedFeature(std::string name, Curve curve, double min_x, double max_x)
+      : TabulatedFeature(name, curve, min_x, max_x, DEFAULT_SAMPLES) {}
+
+  /// Curve defined by polynomial coefficients, in increasing degree order
+  static Curve Polynomial(std::vector<double> coefficients);
+
+  /// Curve defined by sub-curves, each applying up to and including its upper
+  /// x bound. The final sub-curve also applies beyond its bound.
+  static Curve Piecewise(std::vector<std::pair<double, Curve>> pieces);
+
+  /// Curve linearly interpolating measured (x, y) samples
+  static Curve Measured(std::vector<std::pair<double, double>> samples);
+
+  static double SolvePolynomial(double x,
+                                const std::vector<double> &coefficients);
+
+  double Lookup(double x) const {
+    const double position = (x - min_x) * inverse_step;
+
+    // Negated comparison also catches NaN inputs
+    if (!(position > 0)) {
+      return table.front();
+    }
+
+    const std::size_t index = static_cast<std::size_t>(position);
+    if (index >= table.size() - 1) {
+      return table.back();
+    }
+
+    const double t = position - index;
+    return table[index] + t * (table[index + 1] - table[index]);
+  }
+
+  double Calculate(TsrState &state) override;
+};
+
+} // namespace tsr
@@ -1,8 +1,11 @@
+#pragma once
+
 #include "tsr/Point2.hpp"
 #include "tsr/Point3.hpp"
 #include "tsr/Tin.hpp"
 #include "tsr/TsrState.hpp"
 
+#include <ostream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -23,4 +26,10 @@ std::string GenerateKmlDocument(const std::string &inner_kml);
 
 std::string GenerateKmlLine(std::pair<Point3, Point3> line);
 
+/// Streaming alternatives, avoiding building the whole document in memory
+void WriteKmlDocumentStart(std::ostream &stream);
+void WriteKmlDocumentEnd(std::ostream &stream);
+void WriteKmlLine(std::ostream &stream, const Point3 &source,
+                  const Point3 &target);
+
 } // namespace tsr::IO
\ No newline at end of file
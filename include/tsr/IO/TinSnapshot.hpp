@@ -0,0 +1,49 @@
+#pragma once
+
+#include "tsr/Features/RasterFeature.hpp"
+#include "tsr/MeshBoundary.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/Tin.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tsr::IO {
+
+/// Path constraint segment, marked onto the TIN edges it was inserted along
+typedef std::pair<Point3, Point3> PathSegment;
+
+/**
+ * @brief Writes a tagged TIN to a binary snapshot of flat arrays: the
+ * vertices, the faces with their adjacency, constraint and path flags and
+ * tags, the per-tag values of each raster feature, and the path segments the
+ * path flags were marked from.
+ *
+ * The snapshot is tied to the boundary the TIN was built for, and to the
+ * order of the raster features. It is written to a temporary file beside the
+ * path and then renamed, so readers never see a partial snapshot.
+ *
+ * @return false if the file could not be written, or the features have
+ * different numbers of tags
+ */
+bool WriteTinSnapshot(const std::string &filepath, const Tin &tin,
+                      const MeshBoundary &boundary,
+                      const std::vector<const RasterFeature *> &features,
+                      const std::vector<PathSegment> &path_segments);
+
+/**
+ * @brief Memory maps a snapshot written by WriteTinSnapshot and rebuilds the
+ * TIN's data structure directly from it, without inserting any points or
+ * constraints. The raster features are given the snapshot's tags, so the TIN
+ * can be routed over immediately, and the path segments are restored so the
+ * paths can be marked again after the TIN changes.
+ *
+ * @return false if the snapshot does not exist, or was written for another
+ * boundary or set of features. Throws if the snapshot is malformed.
+ */
+bool LoadTinSnapshot(const std::string &filepath, const MeshBoundary &boundary,
+                     Tin &tin, const std::vector<RasterFeature *> &features,
+                     std::vector<PathSegment> &path_segments);
+
+} // namespace tsr::IO
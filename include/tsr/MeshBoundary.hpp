@@ -7,7 +7,17 @@
 
 namespace tsr {
 
+/// Distance inside the boundary edge within which routes may search, in
+/// metres
+#define BOUNDARY_SAFE_DISTANCE 30
+
 class MeshBoundary {
+private:
+  /// Splits a contour at the boundary edge, returning the pieces either
+  /// inside or outside it
+  std::vector<std::vector<Point2>>
+  SplitContour(const std::vector<Point2> &contour, bool keep_inside) const;
+
 public:
   double width;
   double height;
@@ -31,6 +41,41 @@ public:
 
   void FilterPointsOutsideBoundary(std::vector<Point3> points) const;
 
+  /**
+   * @brief Clips a contour to the boundary, returning the pieces of the
+   * contour inside it. Crossing segments are cut at the boundary edge.
+   */
+  std::vector<std::vector<Point2>>
+  ClipContour(const std::vector<Point2> &contour) const;
+
+  /// Clips each contour to the boundary, discarding those outside it
+  std::vector<std::vector<Point2>>
+  ClipContours(const std::vector<std::vector<Point2>> &contours) const;
+
+  /**
+   * @brief Removes the part of a contour inside the boundary, returning the
+   * pieces outside it. Pieces are cut at the same points ClipContour cuts the
+   * contour, so they meet the pieces inside exactly.
+   */
+  std::vector<std::vector<Point2>>
+  SubtractContour(const std::vector<Point2> &contour) const;
+
+  /// Removes the part of each contour inside the boundary
+  std::vector<std::vector<Point2>>
+  SubtractContours(const std::vector<std::vector<Point2>> &contours) const;
+
+  /**
+   * @brief Distance of a point from the segment between the source and target
+   * points the boundary was built around.
+   */
+  double DistanceFromAxis(const Point2 &p) const;
+
+  /**
+   * @brief Whether the safe region of the other boundary, which routes within
+   * it may search, lies inside this boundary.
+   */
+  bool ContainsSafe(const MeshBoundary &other) const;
+
   Point2 GetLowerLeftPoint() const;
   Point2 GetUpperRightPoint() const;
 };
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "tsr/Features/BoolWaterFeature.hpp"
+#include "tsr/Features/CEHTerrainFeature.hpp"
+#include "tsr/Features/GradientSpeedFeature.hpp"
+#include "tsr/Features/PathFeature.hpp"
+
+#include <memory>
+
+namespace tsr {
+
+/**
+ * @brief Features backing the cost functions of the built-in presets. The
+ * data features hold the TIN tags, so they are shared between the presets
+ * rather than owned by any single cost function.
+ *
+ */
+struct PresetFeatures {
+  std::shared_ptr<CEHTerrainFeature> terrain;
+  std::shared_ptr<BoolWaterFeature> water;
+  std::shared_ptr<PathFeature> paths;
+  std::shared_ptr<GradientSpeedFeature> gradient_speed;
+};
+
+} // namespace tsr
@@ -1,9 +1,59 @@
+#pragma once
+
+#include "tsr/DelaunayTriangulation.hpp"
 #include "tsr/FeatureManager.hpp"
 #include "tsr/MeshBoundary.hpp"
+#include "tsr/PresetFeatures.hpp"
 #include "tsr/Tin.hpp"
 
+#include <string>
+
 namespace tsr {
 
+/// Builds the preset data features, without fetching any data
+PresetFeatures CreatePresetFeatures();
+
+/// Fetches and processes the data of every feature concurrently, as none of
+/// them modify the mesh
+void PreparePresetFeatureData(const PresetFeatures &features,
+                              const MeshBoundary &boundary);
+
+/// Adds the prepared feature data to the mesh and tags it
+void ApplyPresetFeatures(Tin &tin, const PresetFeatures &features);
+
+/// Builds the data features, adds their constraints to the TIN and tags it.
+/// The result can be shared by any number of presets over the same TIN.
+PresetFeatures SetupPresetFeatures(Tin &tin, const MeshBoundary &boundary);
+
+/// Initializes the TIN from the DEM while the feature data is fetched, joining
+/// the two only to add the feature constraints and tag the TIN. Setup time is
+/// then bound by the slower of the two rather than their sum.
+PresetFeatures SetupTinWithPresetFeatures(
+    Tin &tin, const MeshBoundary &boundary, const std::string &api_key,
+    const ChunkPipelineOptions &pipeline_options = ChunkPipelineOptions());
+
+/// Updates the feature tags after further constraints were added to an
+/// already tagged TIN, tagging only the faces created or changed by them
+void RetagPresetFeatures(const Tin &tin, const PresetFeatures &features);
+
+/// Writes the TIN and the preset feature tags to a snapshot of the region
+bool WritePresetSnapshot(const std::string &filepath, const Tin &tin,
+                         const MeshBoundary &boundary,
+                         const PresetFeatures &features);
+
+/// Loads the TIN and preset features from a snapshot of the region, which
+/// can be routed over without fetching, inserting or tagging anything.
+/// Returns false if there is no snapshot of the region at the path.
+bool LoadPresetSnapshot(const std::string &filepath,
+                        const MeshBoundary &boundary, Tin &tin,
+                        PresetFeatures &features);
+
+/// Compose the cost graphs over already tagged feature data
+FeatureManager SetupTimePreset(const PresetFeatures &features);
+FeatureManager SetupTimeWithSwimmingPreset(const PresetFeatures &features);
+FeatureManager SetupTimeRestrictSwimmingPreset(const PresetFeatures &features);
+
+/// Convenience overloads which also set up the feature data
 FeatureManager SetupTimePreset(Tin &tin, const MeshBoundary &boundary);
 FeatureManager SetupTimeWithSwimmingPreset(Tin &tin,
                                            const MeshBoundary &boundary);
@@ -17,4 +67,4 @@ FeatureManager SetupSimpleDistancePreset();
 /// abs(gradient))
 FeatureManager SetupSimpleGradientPreset();
 
-} // namespace tsr
\ No newline at end of file
+} // namespace tsr
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "tsr/Point3.hpp"
+
+#include <gdal/gdal.h>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace tsr {
+
+/**
+ * @brief A raster tile with all its bands loaded into one contiguous,
+ * band-sequential buffer, so sampling a pixel is an array index rather than
+ * a GDALRasterIO call.
+ *
+ */
+class RasterTile {
+private:
+  int width = 0;
+  int height = 0;
+  int band_count = 0;
+
+  GDALDataType data_type = GDT_Unknown;
+  std::size_t value_size = 0;
+
+  std::array<double, 6> geotransform = {};
+
+  std::vector<std::byte> data;
+
+public:
+  /// Reads every band of the dataset, converting values to the given type.
+  /// The dataset may be released once the tile is constructed.
+  RasterTile(GDALDatasetH dataset, GDALDataType data_type);
+
+  int GetWidth() const { return width; }
+  int GetHeight() const { return height; }
+  int GetBandCount() const { return band_count; }
+  GDALDataType GetDataType() const { return data_type; }
+  const std::array<double, 6> &GetGeoTransform() const { return geotransform; }
+
+  /// Finds the pixel containing a point in the tile's coordinate system.
+  /// Returns false if the point lies outside the tile.
+  bool GetPixel(const Point3 &point, int &x, int &y) const;
+
+  /// Value of a pixel, where T must match the tile's data type and band is
+  /// zero-indexed
+  template <typename T> T Value(int band, int x, int y) const {
+    const std::size_t index =
+        (static_cast<std::size_t>(band) * height + y) * width + x;
+
+    T value;
+    std::memcpy(&value, &data[index * sizeof(T)], sizeof(T));
+    return value;
+  }
+};
+
+} // namespace tsr
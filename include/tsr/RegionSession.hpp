@@ -0,0 +1,87 @@
+#pragma once
+
+#include "tsr/ChunkInfo.hpp"
+#include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/MeshBoundary.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/PresetFeatures.hpp"
+#include "tsr/Tin.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace tsr {
+
+/**
+ * @brief Keeps a tagged TIN and its preset features between queries of a
+ * long-lived process, so queries within the regions already loaded reuse
+ * them rather than rebuilding anything.
+ *
+ * A query outside the loaded regions grows the TIN instead of replacing it.
+ * Only the DEM chunks not already covered by a loaded region are built, and
+ * only their points and feature constraints outside the loaded regions are
+ * inserted. Only the faces they create or change are retagged.
+ */
+class RegionSession {
+public:
+  /// Builds the TIN of the DEM chunks covering the boundary which the filter
+  /// keeps
+  typedef std::function<Tin(const MeshBoundary &, const ChunkFilter &)>
+      TinSource;
+
+  /// Fetches and processes the feature data covering the boundary
+  typedef std::function<void(const PresetFeatures &, const MeshBoundary &)>
+      FeatureDataSource;
+
+private:
+  TinSource tin_source;
+  FeatureDataSource feature_data_source;
+
+  Tin tin;
+  PresetFeatures features;
+
+  /// Boundaries the TIN was built or grown over
+  std::vector<MeshBoundary> regions;
+
+  void Load(const MeshBoundary &boundary);
+
+  void Grow(const MeshBoundary &boundary);
+
+public:
+  /// Builds the TIN from the DEM and fetches the preset feature data
+  RegionSession(const std::string &api_key,
+                const ChunkPipelineOptions &pipeline_options =
+                    ChunkPipelineOptions());
+
+  /// Builds the TIN and prepares the feature data from the given sources
+  RegionSession(TinSource tin_source, FeatureDataSource feature_data_source);
+
+  /// Whether the point lies in any loaded region
+  bool IsLoaded(const Point3 &point) const;
+
+  /// Whether the whole DEM chunk lies in a loaded region, so its points are
+  /// already in the TIN
+  bool IsLoaded(const ChunkInfo &chunk) const;
+
+  /// Whether routes within the boundary can search the loaded TIN as is
+  bool Contains(const MeshBoundary &boundary) const;
+
+  /**
+   * @brief Loads the TIN and features over the boundary, growing them if the
+   * boundary is not already contained in a loaded region.
+   *
+   * @return Whether anything was built
+   */
+  bool Prepare(const MeshBoundary &boundary);
+
+  const Tin &GetTin() const { return this->tin; }
+
+  const PresetFeatures &GetFeatures() const { return this->features; }
+
+  const std::vector<MeshBoundary> &GetRegions() const {
+    return this->regions;
+  }
+};
+
+} // namespace tsr
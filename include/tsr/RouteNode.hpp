@@ -1,39 +1,49 @@
 #pragma once
 
+#include "tsr/CompactTin.hpp"
 #include "tsr/Tin.hpp"
 #include <functional>
 #include <limits>
 
 namespace tsr {
 
-class RouteNode {
+template <typename TinType> class BasicRouteNode {
 public:
+  typedef typename TinType::Vertex_handle Vertex_handle;
+  typedef typename TinType::Face_handle Face_handle;
+
   double gCost;
   bool closed;
   Vertex_handle vertex;
   Face_handle face;
   Vertex_handle parent;
 
-  RouteNode() = default;
-  RouteNode(Vertex_handle vertex, Face_handle face)
+  BasicRouteNode() = default;
+  BasicRouteNode(Vertex_handle vertex, Face_handle face)
       : gCost(std::numeric_limits<double>::infinity()), closed(false),
         vertex(vertex), face(face), parent(nullptr) {}
 
-  bool operator==(const RouteNode &other) const {
+  bool operator==(const BasicRouteNode &other) const {
     return this->vertex == other.vertex;
   }
 };
 
+typedef BasicRouteNode<Tin> RouteNode;
+typedef BasicRouteNode<CompactTin> CompactRouteNode;
+
 struct CompareNode {
-  bool operator()(const RouteNode &node1, const RouteNode &node2) {
+  template <typename TinType>
+  bool operator()(const BasicRouteNode<TinType> &node1,
+                  const BasicRouteNode<TinType> &node2) const {
     return node1.gCost > node2.gCost;
   }
 };
 
 struct HashNode {
-  bool operator()(const RouteNode &node1) {
-    return std::hash<Vertex_handle>()(node1.vertex);
+  template <typename TinType>
+  std::size_t operator()(const BasicRouteNode<TinType> &node1) const {
+    return std::hash<typename TinType::Vertex_handle>()(node1.vertex);
   }
 };
 
-} // namespace tsr
\ No newline at end of file
+} // namespace tsr
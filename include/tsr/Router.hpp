@@ -1,32 +1,181 @@
 #pragma once
 
+#include "tsr/CompactTin.hpp"
 #include "tsr/FeatureManager.hpp"
+#include "tsr/IO/KMLWriter.hpp"
+#include "tsr/Logging.hpp"
 #include "tsr/MeshBoundary.hpp"
 #include "tsr/Point3.hpp"
+#include "tsr/RouteNode.hpp"
 #include "tsr/Tin.hpp"
 
 #include "tsr/TsrState.hpp"
 
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
 namespace tsr {
 
 /**
  * @brief Accepts a DTM and two points, returns the optimal route between them
- * using Dijkstra's shortest path search algorithm with a custom cost function
- * defined in FeatureManager.
+ * using Dijkstra's shortest path search algorithm with a custom cost function.
+ *
+ * The cost function is any type with a `double Calculate(State &) const` for
+ * the router's state type. Routes over a Tin may use a runtime FeatureManager
+ * graph or a compile-time composed preset from CostModel.hpp, and routes over
+ * a CompactTin a composed preset.
+ *
+ * Defined for Tin and CompactTin in Router.cpp.
  *
  */
-class Router {
+template <typename TinType> class BasicRouter {
+public:
+  typedef typename TinType::Vertex_handle Vertex_handle;
+  typedef typename TinType::Face_handle Face_handle;
+  typedef BasicTsrState<TinType> State;
+
 private:
-  TsrState state;
-  double CalculateTrivialCost(const FeatureManager &fm, TsrState &state);
+  State state;
 
 public:
-  Vertex_handle CalculateNearestVertexToPoint(const Tin &tin, const Point3 &point);
+  Vertex_handle CalculateNearestVertexToPoint(const TinType &tin,
+                                              const Point3 &point);
 
-  std::vector<Point3> Route(const Tin &tin, FeatureManager &fm,
-                                     const MeshBoundary &boundary,
-                                     const Point3 &start_point,
-                                     const Point3 &end_point);
+  template <typename CostFunction>
+  std::vector<Point3> Route(const TinType &tin, const CostFunction &cost,
+                            const MeshBoundary &boundary,
+                            const Point3 &start_point,
+                            const Point3 &end_point);
 };
 
-} // namespace tsr
\ No newline at end of file
+extern template class BasicRouter<Tin>;
+extern template class BasicRouter<CompactTin>;
+
+typedef BasicRouter<Tin> Router;
+typedef BasicRouter<CompactTin> CompactRouter;
+
+template <typename TinType>
+template <typename CostFunction>
+std::vector<Point3> BasicRouter<TinType>::Route(const TinType &tin,
+                                                const CostFunction &cost,
+                                                const MeshBoundary &boundary,
+                                                const Point3 &start_point,
+                                                const Point3 &end_point) {
+
+  TSR_LOG_TRACE("Routing");
+
+  // Fetch the nearest search node to the given points
+  this->state.start_vertex = CalculateNearestVertexToPoint(tin, start_point);
+  this->state.end_vertex = CalculateNearestVertexToPoint(tin, end_point);
+
+  // Setup the queue of gCosts to calculate and CLOSED set
+  typedef BasicRouteNode<TinType> Node;
+  std::priority_queue<Node, std::vector<Node>, CompareNode> cost_queue;
+
+  // Initialize the start node
+  Node startNode(this->state.start_vertex, nullptr);
+  startNode.gCost = 0;
+  cost_queue.push(startNode);
+
+  /**
+   * From the current node, calculate the cost of traversing to the
+   * connected nodes
+   * - We need the face, the adjacent face connecting the next node, and the
+   * vertices
+   */
+  TSR_LOG_TRACE("Starting search");
+  while (!this->state.routes.contains(this->state.end_vertex)) {
+
+    // Select best node from queue
+    Node current_node = cost_queue.top();
+    cost_queue.pop();
+
+    // Check if this route is already beaten
+    if (this->state.routes.contains(current_node.vertex)) {
+      continue;
+    }
+
+    // Check if the route is possible
+    if (current_node.gCost == std::numeric_limits<double>::infinity()) {
+      TSR_LOG_FATAL("Could not find safe path");
+      if constexpr (std::is_same_v<TinType, Tin>) {
+        IO::writeFailureStateToKML("failure.kml", state);
+      }
+      throw std::runtime_error("Could not find safe path");
+    }
+
+    // Add this as the best_route to that node
+    this->state.routes[current_node.vertex] = current_node;
+    this->state.current_vertex = current_node.vertex;
+
+    /**
+     * Calculate the costs of the adjacent not-closed nodes
+     */
+
+    if (!tin.is_valid()) {
+      TSR_LOG_FATAL("Invalid DTM detected");
+      throw std::runtime_error("Invalid DTM detected");
+    }
+
+    // Fetch each vertices
+    auto faceCirculator = current_node.vertex->incident_faces();
+    if (faceCirculator != nullptr) {
+      auto faceCirculatorEnd = faceCirculator;
+      do {
+
+        auto face = faceCirculator;
+        if (tin.is_infinite(face)) {
+          continue;
+        }
+
+        this->state.current_face = face;
+
+        // Get vertices of adjacent face
+        for (int i = 0; i < 3; i++) {
+          Vertex_handle connectedVertex = face->vertex(i);
+          if (connectedVertex == current_node.vertex) {
+            continue;
+          }
+
+          // Skip vertices already searched
+          if (this->state.routes.contains(connectedVertex)) {
+            continue;
+          }
+
+          // Check the point is bounded
+          if (!boundary.IsBoundedSafe(VertexPoint(connectedVertex))) {
+            continue;
+          }
+
+          // Calculate the cost
+          Node node(connectedVertex, face);
+          this->state.next_vertex = connectedVertex;
+          node.gCost = current_node.gCost + cost.Calculate(this->state);
+          node.parent = current_node.vertex;
+
+          // Add the node to the priority queue
+          cost_queue.push(node);
+        }
+      } while (++faceCirculator != faceCirculatorEnd);
+    }
+  }
+
+  auto route = this->state.fetchRoute();
+
+  TSR_LOG_TRACE("Cost queue has {} nodes skipped", cost_queue.size());
+  TSR_LOG_TRACE("Sucessfully analysed {} nodes", this->state.routes.size());
+
+  // Filter the warnings along the route. The KML output only supports Tin
+  // states.
+  if constexpr (std::is_same_v<TinType, Tin>) {
+    IO::writeSuccessStateToKML("success.kml", state);
+  }
+
+  TSR_LOG_TRACE("Completed!");
+  return route;
+}
+
+} // namespace tsr
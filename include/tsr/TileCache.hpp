@@ -0,0 +1,68 @@
+#pragma once
+
+#include "tsr/ChunkInfo.hpp"
+#include "tsr/RasterTile.hpp"
+
+#include <gdal/gdal.h>
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace tsr {
+
+/**
+ * @brief Thread-safe least recently used cache of raster tiles loaded from
+ * the chunk cache. Tiles missing from the chunk cache are remembered too, so
+ * repeated lookups of a missing tile don't touch the filesystem.
+ *
+ */
+class TileCache {
+private:
+  struct TileKey {
+    std::string cache_id;
+    ChunkInfo chunk;
+    GDALDataType data_type;
+
+    bool operator==(const TileKey &other) const {
+      return cache_id == other.cache_id && chunk == other.chunk &&
+             data_type == other.data_type;
+    }
+  };
+
+  struct TileKeyHash {
+    std::size_t operator()(const TileKey &key) const;
+  };
+
+  typedef std::pair<TileKey, std::shared_ptr<const RasterTile>> Entry;
+
+  std::size_t capacity;
+
+  mutable std::mutex mutex;
+
+  /// Most recently used first
+  std::list<Entry> entries;
+  std::unordered_map<TileKey, std::list<Entry>::iterator, TileKeyHash> index;
+
+public:
+  static constexpr std::size_t DEFAULT_CAPACITY = 16;
+
+  explicit TileCache(std::size_t capacity = DEFAULT_CAPACITY)
+      : capacity(capacity) {}
+
+  /// Gets a tile, loading it on a miss. Returns nullptr if the tile is not in
+  /// the chunk cache. Tiles stay valid while referenced, even once evicted.
+  std::shared_ptr<const RasterTile> Get(const std::string &cache_id,
+                                        const ChunkInfo &chunk,
+                                        GDALDataType data_type);
+
+  void Clear();
+
+  std::size_t Size() const;
+};
+
+} // namespace tsr
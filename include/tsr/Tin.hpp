@@ -2,6 +2,7 @@
 
 #include <CGAL/Constrained_Delaunay_triangulation_2.h>
 #include <CGAL/Constrained_triangulation_2.h>
+#include <CGAL/Constrained_triangulation_face_base_2.h>
 #include <CGAL/Default.h>
 #include <CGAL/Delaunay_mesh_face_base_2.h>
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
@@ -9,15 +10,120 @@
 #include <CGAL/Triangulation_data_structure_2.h>
 #include <CGAL/Triangulation_vertex_base_2.h>
 
+#include <atomic>
+#include <cstdint>
+
 namespace tsr {
 
 typedef CGAL::Exact_predicates_inexact_constructions_kernel TIN_K;
 typedef CGAL::Exact_predicates_tag TIN_It;
 typedef CGAL::Projection_traits_xy_3<TIN_K> TIN_Pt;
 
+/**
+ * @brief Constrained face base which additionally stores a 3-bit mask marking
+ * which of the face's edges lie on a path. Bit i refers to the edge opposite
+ * vertex i, matching CGAL's edge indexing.
+ *
+ * Faces also store a tag ID, indexing the per-face tags of data features, and
+ * a signature of the IDs of the vertices they were tagged with. Faces created or changed
+ * by later insertions either have no tag ID or a stale signature.
+ */
+template <class Gt, class Fb = CGAL::Constrained_triangulation_face_base_2<Gt>>
+class TinFaceBase : public Fb {
+private:
+  std::uint8_t path_mask = 0;
+  std::uint32_t face_tag_id = UNTAGGED;
+  std::uint32_t face_tag_signature = 0;
+
+public:
+  static constexpr std::uint32_t UNTAGGED = UINT32_MAX;
+
+  typedef typename Fb::Vertex_handle Vertex_handle;
+  typedef typename Fb::Face_handle Face_handle;
+
+  template <typename TDS2> struct Rebind_TDS {
+    typedef typename Fb::template Rebind_TDS<TDS2>::Other Fb2;
+    typedef TinFaceBase<Gt, Fb2> Other;
+  };
+
+  TinFaceBase() : Fb() {}
+
+  TinFaceBase(Vertex_handle v0, Vertex_handle v1, Vertex_handle v2)
+      : Fb(v0, v1, v2) {}
+
+  TinFaceBase(Vertex_handle v0, Vertex_handle v1, Vertex_handle v2,
+              Face_handle n0, Face_handle n1, Face_handle n2)
+      : Fb(v0, v1, v2, n0, n1, n2) {}
+
+  bool is_path(int i) const { return (path_mask >> i) & 1; }
+
+  bool has_path() const { return path_mask != 0; }
+
+  void set_path(int i, bool is_path) {
+    if (is_path) {
+      path_mask |= (1 << i);
+    } else {
+      path_mask &= ~(1 << i);
+    }
+  }
+
+  void clear_paths() { path_mask = 0; }
+
+  std::uint32_t tag_id() const { return face_tag_id; }
+
+  void set_tag_id(std::uint32_t id) { face_tag_id = id; }
+
+  std::uint32_t tag_signature() const { return face_tag_signature; }
+
+  void set_tag_signature(std::uint32_t signature) {
+    face_tag_signature = signature;
+  }
+};
+
+/// Next vertex ID, shared by every TIN so chunk TINs built in parallel never
+/// reuse an ID
+inline std::uint32_t NextTinVertexId() {
+  static std::atomic<std::uint32_t> next_id = 0;
+  return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Vertex base which additionally stores an ID assigned on creation.
+ * Unlike a vertex's address, which CGAL reuses once the vertex is removed,
+ * the ID identifies the vertex for its whole lifetime, and is kept when the
+ * TIN is copied.
+ */
+template <class Gt, class Vb = CGAL::Triangulation_vertex_base_2<Gt>>
+class TinVertexBase : public Vb {
+private:
+  std::uint32_t vertex_id = NextTinVertexId();
+
+public:
+  typedef typename Vb::Face_handle Face_handle;
+  typedef typename Vb::Point Point;
+
+  template <typename TDS2> struct Rebind_TDS {
+    typedef typename Vb::template Rebind_TDS<TDS2>::Other Vb2;
+    typedef TinVertexBase<Gt, Vb2> Other;
+  };
+
+  TinVertexBase() : Vb() {}
+
+  TinVertexBase(const Point &p) : Vb(p) {}
+
+  TinVertexBase(const Point &p, Face_handle f) : Vb(p, f) {}
+
+  TinVertexBase(Face_handle f) : Vb(f) {}
+
+  std::uint32_t id() const { return vertex_id; }
+};
+
+typedef TinVertexBase<TIN_Pt> TIN_Vb;
+typedef TinFaceBase<TIN_Pt> TIN_Fb;
+typedef CGAL::Triangulation_data_structure_2<TIN_Vb, TIN_Fb> TIN_Tds;
+
 // Define the Delaunay triangulation
-typedef CGAL::Constrained_Delaunay_triangulation_2<TIN_Pt, CGAL::Default,
-                                                   TIN_It>
+typedef CGAL::Constrained_Delaunay_triangulation_2<TIN_Pt, TIN_Tds, TIN_It>
     Tin;
 
 // Define commonly used features of the mesh
@@ -25,4 +131,9 @@ typedef Tin::Vertex_handle Vertex_handle;
 typedef Tin::Face_handle Face_handle;
 typedef Tin::Edge Edge;
 
-} // namespace tsr
\ No newline at end of file
+/// Position of a TIN vertex, matching VertexPoint of compact TINs
+inline const Tin::Point &VertexPoint(const Vertex_handle &vertex) {
+  return vertex->point();
+}
+
+} // namespace tsr
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "tsr/MeshBoundary.hpp"
+#include "tsr/Tin.hpp"
+
+#include <gdal/gdal.h>
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace tsr {
+
+struct TinBuilderOptions {
+  /// Maximum vertical distance, in metres, of any raster sample from the TIN.
+  /// Must be positive.
+  double max_error = 1.0;
+
+  /// Maximum number of TIN vertices, or 0 for no limit
+  std::size_t max_vertices = 0;
+
+  /// Corridor the TIN is routed through. Beyond the full resolution distance
+  /// from its axis, the maximum error grows linearly to edge_max_error at its
+  /// edges. Without a corridor, max_error applies everywhere.
+  std::optional<MeshBoundary> corridor;
+
+  /// Fraction of the corridor's half height built to max_error
+  double full_resolution_fraction = 0.25;
+
+  /// Maximum error at the corridor's edges, in metres
+  double edge_max_error = 10.0;
+};
+
+/**
+ * @brief Builds a TIN approximating an elevation grid by greedy insertion, in
+ * the style of Garland and Heckbert. Starting from the convex hull of the
+ * valid samples, the sample furthest vertically from the TIN is inserted
+ * until every sample is within the maximum error, or the vertex budget is
+ * reached.
+ *
+ * Vertices are raster samples, so keep their measured elevations. With a
+ * corridor, samples are compared against the maximum error at their position,
+ * so the TIN coarsens away from the route.
+ *
+ * @param elevations Row-major grid of elevations
+ * @param geotransform GDAL GeoTransform of the grid, which must be north up
+ * @param nodata_value Elevation of samples without data
+ */
+Tin CreateTinFromElevationGrid(const std::vector<float> &elevations, int width,
+                               int height,
+                               const std::array<double, 6> &geotransform,
+                               float nodata_value,
+                               const TinBuilderOptions &options);
+
+/// Builds a TIN from the first band of an elevation raster dataset
+Tin CreateTinFromDataset(GDALDatasetH dataset,
+                         const TinBuilderOptions &options);
+
+} // namespace tsr
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "tsr/MeshBoundary.hpp"
+#include "tsr/Tin.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace tsr {
+
+/// How a stitched TIN was assembled
+struct TinStitchStats {
+  /// Chunk faces kept as they were
+  std::size_t kept_faces = 0;
+
+  /// Faces re-triangulated along the seams
+  std::size_t seam_faces = 0;
+
+  /// Whether every vertex was inserted instead of assembling the faces
+  bool fell_back = false;
+};
+
+/**
+ * @brief Merges the Delaunay TINs of neighbouring chunks into one Delaunay
+ * TIN of their vertices inside the boundary, keeping each chunk's interior
+ * faces.
+ *
+ * A chunk face whose circumcircle lies well inside the chunk's hull cannot
+ * contain any other chunk's vertices, so it is also a face of the merged TIN.
+ * Only the seam strips between these faces are re-triangulated, from the
+ * vertices bordering them. The faces are then assembled directly into the
+ * merged TIN's data structure.
+ *
+ * Falls back to inserting every vertex if the assembled TIN is invalid, for
+ * example where cocircular vertices are triangulated differently by
+ * neighbouring chunks.
+ *
+ * @param stats If not null, set to how the TIN was assembled
+ */
+Tin StitchChunkTins(const std::vector<std::shared_ptr<const Tin>> &chunks,
+                    const MeshBoundary &boundary,
+                    TinStitchStats *stats = nullptr);
+
+} // namespace tsr
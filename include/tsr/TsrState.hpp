@@ -1,18 +1,28 @@
 #pragma once
 
+#include "tsr/CompactTin.hpp"
 #include "tsr/Point3.hpp"
 #include "tsr/RouteNode.hpp"
+#include "tsr/Tin.hpp"
 
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace tsr {
 
-struct TsrState {
+/**
+ * @brief Search state of a route over either TIN type. Defined for Tin and
+ * CompactTin in TsrState.cpp.
+ */
+template <typename TinType> struct BasicTsrState {
+  typedef typename TinType::Vertex_handle Vertex_handle;
+  typedef typename TinType::Face_handle Face_handle;
 
   Vertex_handle start_vertex;
   Vertex_handle end_vertex;
 
-  std::unordered_map<Vertex_handle, RouteNode> routes;
+  std::unordered_map<Vertex_handle, BasicRouteNode<TinType>> routes;
   Vertex_handle current_vertex;
   Vertex_handle next_vertex;
   Face_handle current_face;
@@ -37,4 +47,10 @@ struct TsrState {
   double estimateTime() const;
 };
 
-} // namespace tsr
\ No newline at end of file
+extern template struct BasicTsrState<Tin>;
+extern template struct BasicTsrState<CompactTin>;
+
+typedef BasicTsrState<Tin> TsrState;
+typedef BasicTsrState<CompactTin> CompactTsrState;
+
+} // namespace tsr
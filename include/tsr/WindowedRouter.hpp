@@ -0,0 +1,83 @@
+#pragma once
+
+#include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/FeatureManager.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/PresetFeatures.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace tsr {
+
+struct WindowedRouterOptions {
+  /// Length of each window along the route's axis, in metres
+  double window_length = 10000;
+
+  /// Length of the end of each window, in metres, which is searched but not
+  /// kept. The next window's search continues from where the kept route ends.
+  double overlap = 2000;
+};
+
+/**
+ * @brief Index of the last vertex of a window's route to keep. This is the
+ * first vertex after the start to reach the overlap, so the route is cut
+ * where it first enters the overlap even if it turns back later. The whole
+ * route is kept in the last window, or if the cut would make no progress
+ * along the axis.
+ *
+ * @param positions Position of each vertex of the window's route along the
+ * axis, of which there must be at least two
+ * @param start_position Position the window's route starts from
+ * @param keep_position Position of the start of the window's overlap
+ */
+std::size_t SelectKeptRouteIndex(const std::vector<double> &positions,
+                                 double start_position, double keep_position,
+                                 bool last_window);
+
+/// Appends a window's route up to and including the kept index. Each window
+/// starts at the last kept vertex, so it is only appended once.
+void AppendWindowRoute(std::vector<Point3> &route,
+                       const std::vector<Point3> &window_route,
+                       std::size_t kept);
+
+/**
+ * @brief Routes between distant points by building the TIN in overlapping
+ * windows along the route's axis, so peak memory is bound by the window size
+ * rather than the route length.
+ *
+ * Each window is built and searched like a short route, from the end of the
+ * route so far to a point one window further along the axis. The route is
+ * kept up to the window's overlap, and the window's TIN and features are then
+ * released before the next is built. The search looks ahead over the
+ * overlap, so the kept route rarely differs from the single TIN route, but it
+ * is not guaranteed to be optimal.
+ */
+class WindowedRouter {
+public:
+  typedef std::function<FeatureManager(const PresetFeatures &)> PresetFactory;
+
+private:
+  std::string api_key;
+  WindowedRouterOptions options;
+  ChunkPipelineOptions pipeline_options;
+
+public:
+  WindowedRouter(const std::string &api_key,
+                 const WindowedRouterOptions &options = WindowedRouterOptions(),
+                 const ChunkPipelineOptions &pipeline_options =
+                     ChunkPipelineOptions());
+
+  /**
+   * @brief Routes between the UTM points, with windows bounded like a route
+   * across their length with the given radii multiplier. The preset builds
+   * the cost graph of each window's features.
+   */
+  std::vector<Point3> Route(const Point3 &start_point, const Point3 &end_point,
+                            double radii_multiplier,
+                            const PresetFactory &preset);
+};
+
+} // namespace tsr
@@ -2,6 +2,8 @@
 #include "tsr/Logging.hpp"
 #include "tsr/IO.hpp"
 #include "tsr/Core.hpp"
+#include "tsr/FeatureProfile.hpp"
+#include "tsr/WindowedRouter.hpp"
 
 #include <boost/program_options/cmdline.hpp>
 #include <boost/program_options/options_description.hpp>
@@ -11,10 +13,12 @@
 #include <boost/program_options/variables_map.hpp>
 
 #include <cfenv>
+#include <cstddef>
 #include <cstdlib>
 #include <exception>
 #include <iostream>
 #include <ostream>
+#include <string>
 #include <vector>
 
 #include "tsr/Config.hpp"
@@ -37,11 +41,10 @@ namespace tsr {
 #include <ratio>
 #endif
 
-bool tsr_run(double sLat, double sLon, double eLat, double eLon) {
-
-#ifdef DEBUG_TIME
+/// Logging, stack and rounding setup shared by each way of running a route
+static void SetupRun() {
   log_set_global_logstream(tsr::LogStream::STDERR);
-#endif
+  log_set_global_loglevel(LogLevel::TRACE);
 
   struct rlimit limit;
   getrlimit(RLIMIT_STACK, &limit);
@@ -49,8 +52,13 @@ bool tsr_run(double sLat, double sLon, double eLat, double eLon) {
   setrlimit(RLIMIT_STACK, &limit);
 
   fesetround(FE_TONEAREST);
+}
 
-  log_set_global_loglevel(LogLevel::TRACE);
+bool tsr_run(double sLat, double sLon, double eLat, double eLon,
+             const ChunkPipelineOptions &pipeline_options,
+             const std::string &snapshot_path) {
+
+  SetupRun();
 
   // Convert points to UTM
   Point3 startPoint = TranslateWgs84PointToUtm(Point3(sLat, sLon, 0));
@@ -70,17 +78,37 @@ bool tsr_run(double sLat, double sLon, double eLat, double eLon) {
   auto timer_initial_tin_start = high_resolution_clock::now();
 #endif
 
-  TSR_LOG_INFO("Initializing TIN");
-  Tin tin = InitializeTinFromBoundary(boundary, OPENTOP_KEY);
+  // The DEM and feature data are fetched together, so are timed together
+  TSR_LOG_INFO("Initializing TIN and features");
+  Tin tin;
+  PresetFeatures features;
+
+  // A snapshot of the region skips fetching, building and tagging the TIN.
+  // A malformed snapshot is rebuilt and overwritten, like a missing one.
+  bool loadedSnapshot = false;
+  if (!snapshot_path.empty()) {
+    try {
+      loadedSnapshot =
+          LoadPresetSnapshot(snapshot_path, boundary, tin, features);
+    } catch (std::exception &e) {
+      TSR_LOG_WARN("ignoring snapshot {}: {}", snapshot_path, e.what());
+    }
+  }
+
+  if (!loadedSnapshot) {
+    features = SetupTinWithPresetFeatures(tin, boundary, OPENTOP_KEY,
+                                          pipeline_options);
+    if (!snapshot_path.empty()) {
+      WritePresetSnapshot(snapshot_path, tin, boundary, features);
+    }
+  }
 
 #ifdef DEBUG_TIME
   auto timer_features_setup = high_resolution_clock::now();
 #endif
 
-  TSR_LOG_TRACE("Vertices: {}", tin.number_of_vertices());
-
   TSR_LOG_INFO("Preparing Feature Manager");
-  FeatureManager fm = SetupTimePreset(tin, boundary);
+  FeatureManager fm = SetupTimePreset(features);
 
 #ifdef DEBUG_TIME
   auto timer_routing_start = high_resolution_clock::now();
@@ -115,6 +143,13 @@ bool tsr_run(double sLat, double sLon, double eLat, double eLon) {
   auto timer_routing_end = high_resolution_clock::now();
 #endif
 
+#ifdef TSR_PROFILE_FEATURES
+  // Output the feature graph profile, ordered by self time
+  auto profile = fm.GetProfile();
+  std::cerr << FormatFeatureProfileTable(profile);
+  IO::WriteDataToFile("profile.json", FormatFeatureProfileJson(profile));
+#endif
+
   // // Convert the points to WGS84
   // std::vector<Point3> routeWGS84;
   // for (auto &point : route) {
@@ -147,6 +182,35 @@ bool tsr_run(double sLat, double sLon, double eLat, double eLon) {
   return routeStatus;
 }
 
+bool tsr_run_windowed(double sLat, double sLon, double eLat, double eLon,
+                      const WindowedRouterOptions &options,
+                      const ChunkPipelineOptions &pipeline_options) {
+
+  SetupRun();
+
+  Point3 startPoint = TranslateWgs84PointToUtm(Point3(sLat, sLon, 0));
+  Point3 endPoint = TranslateWgs84PointToUtm(Point3(eLat, eLon, 0));
+
+  // Each window holds its own TIN, so only one is in memory at a time
+  WindowedRouter router(OPENTOP_KEY, options, pipeline_options);
+
+  TSR_LOG_INFO("Routing in windows of {}m", options.window_length);
+
+  std::vector<Point3> route;
+  try {
+    route = router.Route(startPoint, endPoint, RADII_MULTIPLIER,
+                         [](const PresetFeatures &features) {
+                           return SetupTimePreset(features);
+                         });
+  } catch (std::exception &e) {
+    TSR_LOG_ERROR("{}", e.what());
+    return EXIT_FAILURE;
+  }
+
+  TSR_LOG_INFO("Route has {} points", route.size());
+  return EXIT_SUCCESS;
+}
+
 void PrintUsage() {
   std::cout
       << "Usage: ./tsr-route <start-lat> <start-lon> <end-lat> <end-lon>\n"
@@ -163,6 +227,17 @@ int main(int argc, char **argv) {
     desc.add_options()("help,h", "Print help message")(
         "example", "Run an example with hardcoded coordinates")(
         "disable-cache", "Disables data cache")(
+        "max-fetches", po::value<std::size_t>(),
+        "Maximum number of DEM chunks fetched at once")(
+        "max-chunks", po::value<std::size_t>(),
+        "Maximum number of DEM chunks held in memory at once")(
+        "snapshot", po::value<std::string>(),
+        "Snapshot file of the prepared region, loaded if it exists and "
+        "written otherwise")(
+        "window-length", po::value<double>(),
+        "Route in windows of this length in metres, for long routes")(
+        "window-overlap", po::value<double>(),
+        "Length of each window's end which is searched but not kept")(
         "start-lat", po::value<double>(), "Starting latitude")(
         "start-lon", po::value<double>(), "Starting longitude")(
         "end-lat", po::value<double>(),
@@ -198,8 +273,38 @@ int main(int argc, char **argv) {
       tsr::CacheSetEnabled(false);
     }
 
+    tsr::ChunkPipelineOptions pipelineOptions;
+    if (vm.count("max-fetches")) {
+      pipelineOptions.max_concurrent_fetches =
+          vm["max-fetches"].as<std::size_t>();
+    }
+    if (vm.count("max-chunks")) {
+      pipelineOptions.max_chunks_in_flight = vm["max-chunks"].as<std::size_t>();
+    }
+
+    std::string snapshotPath;
+    if (vm.count("snapshot")) {
+      snapshotPath = vm["snapshot"].as<std::string>();
+    }
+
+    // Routing in windows is only used when a window length is given
+    tsr::WindowedRouterOptions windowOptions;
+    bool windowed = vm.count("window-length") > 0;
+    if (windowed) {
+      windowOptions.window_length = vm["window-length"].as<double>();
+    }
+    if (vm.count("window-overlap")) {
+      windowOptions.overlap = vm["window-overlap"].as<double>();
+    }
+
     if (vm.count("example")) {
-      return tsr::tsr_run(56.777800, -5.024737, 56.809481, -5.025113);
+      if (windowed) {
+        return tsr::tsr_run_windowed(56.777800, -5.024737, 56.809481,
+                                     -5.025113, windowOptions,
+                                     pipelineOptions);
+      }
+      return tsr::tsr_run(56.777800, -5.024737, 56.809481, -5.025113,
+                          pipelineOptions, snapshotPath);
     }
     // Validate positional arguments
     if (!vm.count("start-lat") || !vm.count("start-lon") ||
@@ -214,7 +319,12 @@ int main(int argc, char **argv) {
     double end_lat = vm["end-lat"].as<double>();
     double end_lon = vm["end-lon"].as<double>();
 
-    return tsr::tsr_run(start_lat, start_lon, end_lat, end_lon);
+    if (windowed) {
+      return tsr::tsr_run_windowed(start_lat, start_lon, end_lat, end_lon,
+                                   windowOptions, pipelineOptions);
+    }
+    return tsr::tsr_run(start_lat, start_lon, end_lat, end_lon,
+                        pipelineOptions, snapshotPath);
 
   } catch (const std::exception &e) {
     TSR_LOG_ERROR("{}", e.what());
@@ -280,7 +280,7 @@ DataFile ChunkManager::FetchRasterChunk(const ChunkInfo &chunk) const {
 }
 
 bool ChunkManager::IsAvailableInCache(const std::string &feature_id,
-                                      const ChunkInfo &chunk) {
+                                      const ChunkInfo &chunk) const {
   // check if caching is disabled
   if (!g_cache_enabled) {
     return false;
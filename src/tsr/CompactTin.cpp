@@ -0,0 +1,96 @@
+#include "tsr/CompactTin.hpp"
+#include "tsr/Logging.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/Tin.hpp"
+
+#include <cstdint>
+
+namespace tsr {
+
+namespace {
+
+/// Copies the constraints and per-face tags between the face types, which
+/// share TinFaceBase
+template <typename FaceSrc, typename FaceHandleTgt>
+void CopyFaceData(const FaceSrc &src, FaceHandleTgt tgt) {
+  for (int i = 0; i < 3; i++) {
+    tgt->set_constraint(i, src.is_constrained(i));
+    tgt->set_path(i, src.is_path(i));
+  }
+  tgt->set_tag_id(src.tag_id());
+  tgt->set_tag_signature(src.tag_signature());
+}
+
+struct ToCompactVertex {
+  CompactTin::Vertex operator()(const Tin::Vertex &src) const {
+    CompactTin::Vertex vertex;
+    vertex.set_point(TIN_K::Point_2(src.point().x(), src.point().y()));
+    vertex.info().z = static_cast<float>(src.point().z());
+    return vertex;
+  }
+
+  void operator()(const Tin::Vertex &, CompactVertex_handle) const {}
+};
+
+struct ToCompactFace {
+  CompactTin::Face operator()(const Tin::Face &) const {
+    return CompactTin::Face();
+  }
+
+  void operator()(const Tin::Face &src, CompactFace_handle tgt) const {
+    CopyFaceData(src, tgt);
+  }
+};
+
+struct FromCompactVertex {
+  Tin::Vertex operator()(const CompactTin::Vertex &src) const {
+    Tin::Vertex vertex;
+    vertex.set_point(
+        Point3(src.point().x(), src.point().y(), src.info().z));
+    return vertex;
+  }
+
+  void operator()(const CompactTin::Vertex &, Vertex_handle) const {}
+};
+
+struct FromCompactFace {
+  Tin::Face operator()(const CompactTin::Face &) const { return Tin::Face(); }
+
+  void operator()(const CompactTin::Face &src, Face_handle tgt) const {
+    CopyFaceData(src, tgt);
+  }
+};
+
+} // namespace
+
+CompactTin ConvertTinToCompactTin(const Tin &tin) {
+  CompactTin compactTin;
+
+  // Copying the data structure keeps the triangulation, so nothing is
+  // re-inserted
+  CompactVertex_handle infinite = compactTin.tds().copy_tds(
+      tin.tds(), tin.infinite_vertex(), ToCompactVertex(), ToCompactFace());
+  compactTin.set_infinite_vertex(infinite);
+
+  std::uint32_t id = 0;
+  for (CompactVertex_handle vertex : compactTin.finite_vertex_handles()) {
+    vertex->info().id = id++;
+  }
+
+  TSR_LOG_TRACE("compact TIN has {} vertices", compactTin.number_of_vertices());
+  return compactTin;
+}
+
+Tin ConvertCompactTinToTin(const CompactTin &compact_tin) {
+  Tin tin;
+
+  Vertex_handle infinite = tin.tds().copy_tds(compact_tin.tds(),
+                                              compact_tin.infinite_vertex(),
+                                              FromCompactVertex(),
+                                              FromCompactFace());
+  tin.set_infinite_vertex(infinite);
+
+  return tin;
+}
+
+} // namespace tsr
@@ -5,26 +5,23 @@
 #include "tsr/Point3.hpp"
 #include "tsr/SurfaceMesh.hpp"
 #include "tsr/Tin.hpp"
+#include "tsr/TinBuilder.hpp"
+#include "tsr/TinStitcher.hpp"
 
-#include <CGAL/Polygon_mesh_processing/connected_components.h>
-#include <CGAL/Shape_detection/Region_growing/Region_growing.h>
-#include <CGAL/Polygon_mesh_processing/remesh_planar_patches.h>
-#include <CGAL/Polygon_mesh_processing/repair.h>
-#include <CGAL/Polygon_mesh_processing/repair_degeneracies.h>
-#include <CGAL/Polygon_mesh_processing/repair_polygon_soup.h>
-#include <CGAL/Polygon_mesh_processing/triangulate_faces.h>
 #include <CGAL/boost/graph/copy_face_graph.h>
 #include <CGAL/boost/graph/graph_traits_Constrained_Delaunay_triangulation_2.h>
 #include <CGAL/boost/graph/graph_traits_Surface_mesh.h>
 #include <CGAL/boost/graph/helpers.h>
+#include <CGAL/hilbert_sort.h>
 #include <CGAL/property_map.h>
 #include <CGAL/tags.h>
 
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/operations.hpp>
-#include <boost/property_map/vector_property_map.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <exception>
 #include <gdal.h>
 #include <iterator>
@@ -32,6 +29,7 @@
 #include <memory>
 #include <oneapi/tbb/flow_graph.h>
 #include <set>
+#include <stdexcept>
 #include <string>
 #include <tbb/flow_graph.h>
 #include <tbb/parallel_for.h>
@@ -51,7 +49,7 @@
 
 namespace tsr {
 
-#define TIN_FEATURE_ID "topography"
+#define DEM_FEATURE_ID "dem"
 
 void ConvertSurfaceMeshToTin(SurfaceMesh const &source, Tin &target) {
   for (auto v : source.vertices()) {
@@ -63,6 +61,29 @@ void ConvertTinToSurfaceMesh(Tin const &source, SurfaceMesh &target) {
   CGAL::copy_face_graph(source, target);
 }
 
+void InsertPoints(Tin &tin, std::vector<Point3> &points) {
+
+  // Points sharing an XY position are the same TIN vertex, so keep the first
+  std::stable_sort(points.begin(), points.end(),
+                   [](const Point3 &a, const Point3 &b) {
+                     return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+                   });
+  points.erase(std::unique(points.begin(), points.end(),
+                           [](const Point3 &a, const Point3 &b) {
+                             return a.x() == b.x() && a.y() == b.y();
+                           }),
+               points.end());
+
+  // Consecutive points along a Hilbert curve are close, so each insertion
+  // only walks a short distance from the previous vertex
+  CGAL::hilbert_sort(points.begin(), points.end(), tin.geom_traits());
+
+  Face_handle hint;
+  for (const Point3 &point : points) {
+    hint = tin.insert(point, hint)->face();
+  }
+}
+
 Tin CreateTinFromPoints(const std::vector<Point3> &points) {
   if (points.empty()) {
     TSR_LOG_WARN("empty Tin created");
@@ -70,209 +91,311 @@ Tin CreateTinFromPoints(const std::vector<Point3> &points) {
 
   Tin tin;
 
-  for (auto p : points) {
-    if (p.x() == 0 && p.y() == 0 && p.z() == 0) {
-      TSR_LOG_TRACE("point is zero zero");
-    }
-    tin.insert(p);
-  }
-
-  // tin.insert(points.begin(), points.end());
+  std::vector<Point3> sortedPoints(points);
+  InsertPoints(tin, sortedPoints);
 
   return tin;
 }
 
-std::set<std::pair<Point3, Point3>>
-AddContourConstraint(Tin &tin, std::vector<Point2> contour,
-                     double max_segment_length) {
-
-  std::set<std::pair<Point3, Point3>> constraints;
-
-  for (auto vertexIt = contour.begin(); vertexIt != contour.end(); ++vertexIt) {
-    auto vertexNextIt = std::next(vertexIt);
-    if (vertexNextIt == contour.end())
-      break;
+/**
+ * @brief Locates the point on the TIN surface, walking from the face of the
+ * previously located point. Returns false if the point is outside the TIN.
+ */
+static bool LocateOnSurface(const Tin &tin, double x, double y,
+                            Face_handle &hint, Point3 &point) {
 
-    const double x = vertexIt->x();
-    const double y = vertexIt->y();
+  Face_handle face = tin.locate(Point3(x, y, 0), hint);
 
-    Tin::Face_handle vertexFace = tin.locate(Point3(x, y, 0));
+  if (face == nullptr || tin.is_infinite(face)) {
+    return false;
+  }
+  hint = face;
 
-    if (vertexFace == nullptr || tin.is_infinite(vertexFace)) {
-      // TSR_LOG_WARN("Point outside boundary x: {} y: {}", x, y);
-      continue;
-    }
+  double z = InterpolateZ(face->vertex(0)->point(), face->vertex(1)->point(),
+                          face->vertex(2)->point(), x, y);
+  point = Point3(x, y, z);
+  return true;
+}
 
-    double z = InterpolateZ(vertexFace->vertex(0)->point(),
-                            vertexFace->vertex(1)->point(),
-                            vertexFace->vertex(2)->point(), x, y);
+void CollectContourConstraints(
+    const Tin &tin, const std::vector<Point2> &contour,
+    double max_segment_length,
+    std::vector<std::pair<Point3, Point3>> &constraints, Face_handle &hint) {
 
-    Point3 vertex(vertexIt->x(), vertexIt->y(), z);
+  Point3 vertexPoint;
+  bool vertexInside = false;
 
-    const double next_x = vertexNextIt->x();
-    const double next_y = vertexNextIt->y();
+  for (auto vertexIt = contour.begin(); vertexIt != contour.end(); ++vertexIt) {
 
-    Tin::Face_handle vertexNextFace = tin.locate(Point3(next_x, next_y, 0));
+    // Each contour vertex is located once, continuing the walk from the
+    // previous vertex
+    Point3 vertexNextPoint;
+    bool vertexNextInside = LocateOnSurface(tin, vertexIt->x(), vertexIt->y(),
+                                            hint, vertexNextPoint);
 
-    if (vertexNextFace == nullptr || tin.is_infinite(vertexNextFace)) {
-      // TSR_LOG_WARN("Point outside boundary x: {} y: {}", next_x, next_y);
+    if (vertexIt == contour.begin() || !vertexInside || !vertexNextInside) {
+      vertexPoint = vertexNextPoint;
+      vertexInside = vertexNextInside;
       continue;
     }
 
-    double next_z = InterpolateZ(
-        vertexNextFace->vertex(0)->point(), vertexNextFace->vertex(1)->point(),
-        vertexNextFace->vertex(2)->point(), next_x, next_y);
-
-    Point3 vertexPoint(x, y, z);
-    Point3 vertexNextPoint(next_x, next_y, next_z);
+    const double x = vertexPoint.x();
+    const double y = vertexPoint.y();
 
     // Calculate the Euclidean distance in the XY plane
-    double dx = next_x - x;
-    double dy = next_y - y;
+    double dx = vertexNextPoint.x() - x;
+    double dy = vertexNextPoint.y() - y;
     double length = sqrt(dx * dx + dy * dy);
 
+    // Densify the segment, skipping split points outside the TIN
+    Point3 previous = vertexPoint;
     if (length > max_segment_length) {
       // Calculate the number of splits required
       double splits = floor(length / max_segment_length);
 
-      std::vector<Point3> splitPoints;
       for (double split = 1; split <= splits; split++) {
         double split_x = round(x + (dx / splits) * split);
         double split_y = round(y + (dy / splits) * split);
 
-        Tin::Face_handle vertexSplitFace =
-            tin.locate(Point3(split_x, split_y, 0));
-
-        if (tin.is_infinite(vertexSplitFace)) {
-          // TSR_LOG_ERROR("Point outside boundary x: {} y: {}", split_x,
-          // split_y);
+        Point3 splitPoint;
+        if (!LocateOnSurface(tin, split_x, split_y, hint, splitPoint) ||
+            splitPoint == previous) {
           continue;
         }
 
-        double split_z =
-            InterpolateZ(vertexSplitFace->vertex(0)->point(),
-                         vertexSplitFace->vertex(1)->point(),
-                         vertexSplitFace->vertex(2)->point(), split_x, split_y);
-        splitPoints.push_back(Point3(split_x, split_y, split_z));
+        constraints.push_back({previous, splitPoint});
+        previous = splitPoint;
       }
+    }
 
-      // Add the constraints
-      constraints.insert({vertexPoint, splitPoints[0]});
-      ushort splitIndex;
-      for (splitIndex = 1; splitIndex < splitPoints.size(); splitIndex++) {
-        constraints.insert(
-            {splitPoints[splitIndex - 1], splitPoints[splitIndex]});
-      }
-      constraints.insert({splitPoints[splitIndex - 1], vertexNextPoint});
+    if (previous != vertexNextPoint) {
+      constraints.push_back({previous, vertexNextPoint});
+    }
+
+    vertexPoint = vertexNextPoint;
+    vertexInside = vertexNextInside;
+  }
+}
+
+/// Inserts the constraint segments in a single bulk operation, removing any
+/// duplicates first
+static void
+InsertConstraints(Tin &tin, std::vector<std::pair<Point3, Point3>> &segments) {
+
+  // Overlapping contours share segments
+  std::sort(segments.begin(), segments.end());
+  segments.erase(std::unique(segments.begin(), segments.end()),
+                 segments.end());
+
+  // Bulk insertion spatially sorts the endpoints before inserting them
+  tin.insert_constraints(segments.begin(), segments.end());
+}
+
+std::vector<std::pair<Point3, Point3>>
+AddContourConstraints(Tin &tin,
+                      const std::vector<std::vector<Point2>> &contours,
+                      double max_segment_length) {
+
+  // Interpolate every constraint against the TIN before modifying it
+  std::vector<std::pair<Point3, Point3>> constraints;
+  Face_handle hint;
+  for (const auto &contour : contours) {
+    CollectContourConstraints(tin, contour, max_segment_length, constraints,
+                              hint);
+  }
+
+  InsertConstraints(tin, constraints);
+  return constraints;
+}
+
+std::set<std::pair<Point3, Point3>>
+AddContourConstraint(Tin &tin, const std::vector<Point2> &contour,
+                     double max_segment_length) {
+
+  std::vector<std::pair<Point3, Point3>> constraints;
+  Face_handle hint;
+  CollectContourConstraints(tin, contour, max_segment_length, constraints,
+                            hint);
+
+  InsertConstraints(tin, constraints);
+  return std::set<std::pair<Point3, Point3>>(constraints.begin(),
+                                             constraints.end());
+}
 
+/// Vertices closer than this in XY, in metres, are merged
+static const double MIN_VERTEX_SPACING = 0.01;
+
+/// Unit normal of a finite face, pointing up for counterclockwise faces
+static TIN_K::Vector_3 FaceNormal(Face_handle face) {
+  TIN_K::Vector_3 normal =
+      CGAL::normal(face->vertex(0)->point(), face->vertex(1)->point(),
+                   face->vertex(2)->point());
+
+  double length = std::sqrt(normal.squared_length());
+  return length > 0 ? normal / length : normal;
+}
+
+/**
+ * @brief Whether removing the vertex changes the surface by at most the given
+ * angle and distance. Every incident face must be within the angle of their
+ * mean normal, and the vertex within the distance of the plane through its
+ * neighbours. Hull vertices must also be within the distance of the line
+ * between their hull neighbours, so the hull is only trimmed slightly, and
+ * have at least two finite faces for their angles to be compared.
+ */
+static bool IsVertexRemovable(const Tin &tin, Vertex_handle vertex,
+                              double cosine_max_angle, double max_distance) {
+
+  std::vector<TIN_K::Vector_3> normals;
+  std::vector<Point3> hullNeighbours;
+
+  Tin::Face_circulator face = tin.incident_faces(vertex);
+  Tin::Face_circulator done = face;
+  do {
+    if (tin.is_infinite(face)) {
+      // The finite vertex of an infinite face, other than this one, is a hull
+      // neighbour
+      int index = face->index(vertex);
+      Vertex_handle neighbour = face->vertex(Tin::ccw(index));
+      if (tin.is_infinite(neighbour)) {
+        neighbour = face->vertex(Tin::cw(index));
+      }
+      hullNeighbours.push_back(neighbour->point());
     } else {
-      constraints.insert({vertexPoint, vertexNextPoint});
+      normals.push_back(FaceNormal(face));
     }
+  } while (++face != done);
+
+  // A hull corner with a single face trivially agrees with its own normal,
+  // however steep the face, so has no neighbouring face to be compared with
+  if (normals.empty() || (!hullNeighbours.empty() && normals.size() < 2)) {
+    return false;
   }
 
-  for (auto c : constraints) {
-    tin.insert_constraint(c.first, c.second);
+  TIN_K::Vector_3 meanNormal(0, 0, 0);
+  for (const auto &normal : normals) {
+    meanNormal = meanNormal + normal;
   }
+  meanNormal = meanNormal / std::sqrt(meanNormal.squared_length());
 
-  return constraints;
+  for (const auto &normal : normals) {
+    if (normal * meanNormal < cosine_max_angle) {
+      return false;
+    }
+  }
+
+  // Distance from the plane through the centroid of the neighbours
+  double x = 0;
+  double y = 0;
+  double z = 0;
+  int neighbours = 0;
+  Tin::Vertex_circulator neighbour = tin.incident_vertices(vertex);
+  Tin::Vertex_circulator neighboursDone = neighbour;
+  do {
+    if (!tin.is_infinite(neighbour)) {
+      x += neighbour->point().x();
+      y += neighbour->point().y();
+      z += neighbour->point().z();
+      neighbours++;
+    }
+  } while (++neighbour != neighboursDone);
+
+  const Point3 &p = vertex->point();
+  TIN_K::Vector_3 offset(p.x() - x / neighbours, p.y() - y / neighbours,
+                         p.z() - z / neighbours);
+  if (std::abs(offset * meanNormal) > max_distance) {
+    return false;
+  }
+
+  if (hullNeighbours.size() == 2) {
+    const Point3 &a = hullNeighbours[0];
+    const Point3 &b = hullNeighbours[1];
+
+    double dx = b.x() - a.x();
+    double dy = b.y() - a.y();
+    double length = std::sqrt(dx * dx + dy * dy);
+    double distance =
+        length > 0 ? std::abs(dx * (p.y() - a.y()) - dy * (p.x() - a.x())) /
+                         length
+                   : CalculateXYDistance(p, a);
+
+    if (distance > max_distance) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/// Whether the vertex is within the minimum spacing of any neighbour
+static bool IsNearDuplicate(const Tin &tin, Vertex_handle vertex) {
+  Tin::Vertex_circulator neighbour = tin.incident_vertices(vertex);
+  Tin::Vertex_circulator done = neighbour;
+  do {
+    if (!tin.is_infinite(neighbour) &&
+        CalculateXYDistance(vertex->point(), neighbour->point()) <
+            MIN_VERTEX_SPACING) {
+      return true;
+    }
+  } while (++neighbour != done);
+
+  return false;
 }
 
 void SimplifyTin(Tin const &source_mesh, Tin &target_mesh,
                  float cosine_max_angle_regions, float max_distance_regions,
                  float cosine_max_angle_corners, float max_distance_corners) {
 
-  // Convert the mesh to a Surface_Mesh
-  SurfaceMesh sourceSurfaceMesh;
-  ConvertTinToSurfaceMesh(source_mesh, sourceSurfaceMesh);
-
-  CGAL::Polygon_mesh_processing::remove_degenerate_faces(sourceSurfaceMesh);
-  CGAL::Polygon_mesh_processing::remove_almost_degenerate_faces(
-      sourceSurfaceMesh);
-  CGAL::Polygon_mesh_processing::remove_degenerate_edges(sourceSurfaceMesh);
-  CGAL::Polygon_mesh_processing::triangulate_faces(sourceSurfaceMesh);
-
-  // typedef boost::graph_traits<SurfaceMesh>::vertex_descriptor
-  // vertex_descriptor; typedef
-  // boost::graph_traits<SurfaceMesh>::halfedge_descriptor halfedge_descriptor;
+  // Simplify in place, removing vertices from the triangulation directly
+  if (&source_mesh != &target_mesh) {
+    target_mesh = source_mesh;
+  }
+  Tin &tin = target_mesh;
 
-  if (!CGAL::is_valid_polygon_mesh(sourceSurfaceMesh)) {
-    TSR_LOG_ERROR("Source mesh is invalid!");
+  if (tin.dimension() < 2) {
+    TSR_LOG_WARN("TIN has too few vertices to simplify");
     return;
   }
 
-  // // Required simplification information
-  // std::vector<size_t> regionIdMap(CGAL::num_faces(sourceSurfaceMesh));
-  // std::vector<size_t> cornerIdMap(CGAL::num_vertices(sourceSurfaceMesh), -1);
-  // std::vector<bool> ecm(CGAL::num_edges(sourceSurfaceMesh), false);
-  // boost::vector_property_map<CGAL::Epick::Vector_3> normalMap;
-
-  // TSR_LOG_TRACE("detecting mesh regions for simplification");
-
-  // size_t nbRegions =
-  //     CGAL::Polygon_mesh_processing::region_growing_of_planes_on_faces(
-  //         sourceSurfaceMesh,
-  //         CGAL::make_random_access_property_map(regionIdMap),
-  //         CGAL::parameters::cosine_of_maximum_angle(cosine_max_angle_regions)
-  //             .region_primitive_map(normalMap)
-  //             .maximum_distance(max_distance_regions));
-  // TSR_LOG_TRACE("Detected {} regions", nbRegions);
-
-  // TSR_LOG_TRACE("detecting mesh corners for simplification");
-
-  // size_t nbCorners =
-  // CGAL::Polygon_mesh_processing::detect_corners_of_regions(
-  //     sourceSurfaceMesh, CGAL::make_random_access_property_map(regionIdMap),
-  //     nbRegions, CGAL::make_random_access_property_map(cornerIdMap),
-  //     CGAL::parameters::cosine_of_maximum_angle(cosine_max_angle_corners)
-  //         .maximum_distance(max_distance_corners)
-  //         .edge_is_constrained_map(CGAL::make_random_access_property_map(ecm)));
-  // TSR_LOG_TRACE("Detected {} corners", nbCorners);
-
-  // SurfaceMesh targetSurfaceMesh;
-  // try {
-  //   TSR_LOG_TRACE("simplifying mesh");
-
-  //   // typedef boost::property_map<SurfaceMesh, CGAL::vertex_index_t>::type
-  //   //     VertexIndexMap;
-  //   // VertexIndexMap vim = get(CGAL::vertex_index, sourceSurfaceMesh);
-
-  //   // typedef boost::property_map<SurfaceMesh,
-  //   CGAL::face_patch_id_t<int>>::type
-  //   //     FacePatchIdMap;
-  //   // FacePatchIdMap patch_id_map =
-  //   //     get(CGAL::face_patch_id_t<int>(), sourceSurfaceMesh);
-
-  //   // bool res =
-  //   CGAL::Polygon_mesh_processing::remesh_almost_planar_patches(
-  //   //     sourceSurfaceMesh, targetSurfaceMesh, nbRegions, nbCorners,
-  //   //     CGAL::make_random_access_property_map(regionIdMap),
-  //   //     CGAL::make_random_access_property_map(cornerIdMap),
-  //   //     CGAL::make_random_access_property_map(ecm),
-  //   //     CGAL::parameters::patch_normal_map(normalMap));
-  //   // if (!res) {
-  //   //   throw std::runtime_error("return value indicates failure");
-  //   // }
-  //   TSR_LOG_TRACE("Simplified mesh has {} vertices",
-  //                 sourceSu.number_of_vertices());
-  // } catch (std::exception &e) {
-  //   TSR_LOG_ERROR("simplification failed: {}", e.what());
-  //   throw e;
-  // }
-
-  if (sourceSurfaceMesh.number_of_vertices() == 0) {
-    TSR_LOG_WARN("Empty target surface mesh");
-  }
+  std::vector<Vertex_handle> vertices(tin.finite_vertex_handles().begin(),
+                                      tin.finite_vertex_handles().end());
 
-  // copy the mesh to the target mesh
-  // exceptions here result in an undefined memory state
-  try {
-    TSR_LOG_TRACE("writing to target mesh");
-    target_mesh.clear();
-    ConvertSurfaceMeshToTin(sourceSurfaceMesh, target_mesh);
-  } catch (std::exception &e) {
-    TSR_LOG_FATAL("copying simplified mesh to target mesh failed");
-    throw e;
+  // Neighbours of a removed vertex are kept this pass, so the error of each
+  // removal is measured against the original surface
+  std::set<Vertex_handle> kept;
+  std::size_t removed = 0;
+
+  for (Vertex_handle vertex : vertices) {
+    if (tin.number_of_vertices() <= 3) {
+      break;
+    }
+
+    if (kept.count(vertex) > 0 || tin.are_there_incident_constraints(vertex)) {
+      continue;
+    }
+
+    bool onHull = tin.is_edge(vertex, tin.infinite_vertex());
+
+    if (!IsNearDuplicate(tin, vertex) &&
+        !IsVertexRemovable(
+            tin, vertex,
+            onHull ? cosine_max_angle_corners : cosine_max_angle_regions,
+            onHull ? max_distance_corners : max_distance_regions)) {
+      continue;
+    }
+
+    Tin::Vertex_circulator neighbour = tin.incident_vertices(vertex);
+    Tin::Vertex_circulator done = neighbour;
+    do {
+      kept.insert(neighbour);
+    } while (++neighbour != done);
+
+    tin.remove(vertex);
+    removed++;
   }
+
+  TSR_LOG_TRACE("simplification removed {} of {} vertices", removed,
+                vertices.size());
 }
 
 void SimplifyTin(Tin const &source_mesh, Tin &target_mesh) {
@@ -284,10 +407,16 @@ void SimplifyTin(Tin const &source_mesh, Tin &target_mesh) {
 }
 
 Tin InitializeTinFromBoundary(MeshBoundary boundary, std::string api_key,
-                              std::string url_format) {
-
-  std::vector<ChunkInfo> apiTilesRequired;
-  std::vector<ChunkInfo> cachedTilesRequired;
+                              std::string url_format,
+                              const TinBuilderOptions &options,
+                              const ChunkPipelineOptions &pipeline_options,
+                              const ChunkFilter &chunk_filter) {
+
+  if (pipeline_options.max_concurrent_fetches == 0 ||
+      pipeline_options.max_chunks_in_flight == 0) {
+    TSR_LOG_ERROR("chunk pipeline limits must be at least 1");
+    throw std::runtime_error("chunk pipeline limits must be at least 1");
+  }
 
   const double TILE_SIZE = 0.1;
 
@@ -297,85 +426,84 @@ Tin InitializeTinFromBoundary(MeshBoundary boundary, std::string api_key,
   TSR_LOG_TRACE("getting required DEM chunks");
   auto chunks = chunkManager.GetRequiredChunks(boundary);
 
-  // Loop over the x chunks
+  // Chunk TINs are coarsened away from the corridor's axis, so depend on the
+  // boundary. The DEM rasters are cached instead, and the TINs rebuilt.
+  TinBuilderOptions chunkOptions = options;
+  if (!chunkOptions.corridor) {
+    chunkOptions.corridor = boundary;
+  }
+
+  struct ParallelChunkData {
+    ChunkInfo chunkInfo;
+    bool cached = false;
+    GDALDatasetH dataset = nullptr;
+    std::shared_ptr<Tin> tin;
+  };
+
   TSR_LOG_TRACE("checking chunk cache");
+  std::vector<ParallelChunkData> chunksRequired;
+  std::size_t cachedChunks = 0;
   for (auto chunk : chunks) {
-    if (IO::IsChunkCached(TIN_FEATURE_ID, chunk)) {
-      cachedTilesRequired.push_back(chunk);
-    } else {
-      apiTilesRequired.push_back(chunk);
+    if (chunk_filter && !chunk_filter(chunk)) {
+      continue;
     }
-  }
 
-  TSR_LOG_TRACE("DEM api tiles: {}", apiTilesRequired.size());
-  TSR_LOG_TRACE("DEM cache tiles: {}", cachedTilesRequired.size());
-
-  /*
-   * Try to fetch all of the meshes from the cache
-   *
-   */
-
-  TSR_LOG_TRACE("Fetching chunks from cache");
-  Tin masterTIN;
-  for (auto chunk : cachedTilesRequired) {
-    // Add mesh points in domain to master mesh
-    try {
-      Tin chunkMesh;
-      IO::GetChunkFromCache<Tin>(TIN_FEATURE_ID, chunk, chunkMesh);
-
-      TSR_LOG_TRACE("merging chunk {} {} {} {}", chunk.minLat, chunk.minLng,
-                    chunk.maxLat, chunk.maxLng);
-      MergeTinPointsInBoundary(boundary, chunkMesh, masterTIN);
-    } catch (std::exception &e) {
-      TSR_LOG_ERROR("Cached chunk corrupted");
-      TSR_LOG_ERROR("{}", e.what());
-
-      // Delete the corrupted file
-      IO::DeleteChunkFromCache(TIN_FEATURE_ID, chunk);
-
-      // Add the chunk to the API required tiles
-      apiTilesRequired.push_back(chunk);
-    }
+    ParallelChunkData data;
+    data.chunkInfo = chunk;
+    data.cached = IO::IsChunkCached(DEM_FEATURE_ID, chunk);
+    cachedChunks += data.cached;
+    chunksRequired.push_back(data);
   }
 
-  TSR_LOG_TRACE("master TIN vertices: {}", masterTIN.number_of_vertices());
+  TSR_LOG_TRACE("DEM api tiles: {}", chunksRequired.size() - cachedChunks);
+  TSR_LOG_TRACE("DEM cache tiles: {}", cachedChunks);
+  TSR_LOG_TRACE("DEM skipped tiles: {}", chunks.size() - chunksRequired.size());
 
-  /*
-   * Try to fetch and generate the required meshes from the API
-   *
-   */
-
-  tbb::flow::graph flowGraph;
+  if (chunksRequired.empty()) {
+    return Tin();
+  }
 
-  // Step 1: Fetch data from the API
+  std::vector<std::shared_ptr<const Tin>> chunkTins;
 
-  struct ParallelChunkData {
-    ChunkInfo chunkInfo;
-    std::vector<Point3> points;
-    GDALDatasetH dataset;
-    std::shared_ptr<Tin> tin;
-  };
+  tbb::flow::graph flowGraph;
 
+  // The input node is only called serially, so the index needs no locking
+  std::size_t nextChunk = 0;
   tbb::flow::input_node<ParallelChunkData> input_node(
       flowGraph,
-      [&apiTilesRequired](tbb::flow_control &fc) -> ParallelChunkData {
+      [&chunksRequired,
+       &nextChunk](tbb::flow_control &fc) -> ParallelChunkData {
         // TSR_LOG_TRACE("Input node");
-        static unsigned int count = 0;
-        if (count < apiTilesRequired.size()) {
-          ParallelChunkData data;
-          data.chunkInfo = apiTilesRequired[count];
-          ++count;
-          return data;
-        } else {
-          fc.stop();
+        if (nextChunk < chunksRequired.size()) {
+          return chunksRequired[nextChunk++];
         }
+        fc.stop();
         return {};
       });
 
-  tbb::flow::function_node<ParallelChunkData, ParallelChunkData> api_node(
-      flowGraph, tbb::flow::unlimited,
+  // Chunks pass the limiter when fetched, and release it once collected
+  tbb::flow::limiter_node<ParallelChunkData> limiter_node(
+      flowGraph, pipeline_options.max_chunks_in_flight);
+
+  // Step 1: Load the raster from the cache, or fetch and cache it
+  tbb::flow::function_node<ParallelChunkData, ParallelChunkData> raster_node(
+      flowGraph, pipeline_options.max_concurrent_fetches,
       [&chunkManager](ParallelChunkData data) -> ParallelChunkData {
-        // TSR_LOG_TRACE("API node");
+        // TSR_LOG_TRACE("Raster node");
+        if (data.cached) {
+          try {
+            IO::GetChunkFromCache<GDALDatasetH>(DEM_FEATURE_ID, data.chunkInfo,
+                                                data.dataset);
+            return data;
+          } catch (std::exception &e) {
+            TSR_LOG_ERROR("Cached chunk corrupted");
+            TSR_LOG_ERROR("{}", e.what());
+
+            // Delete the corrupted file, and fetch the chunk instead
+            IO::DeleteChunkFromCache(DEM_FEATURE_ID, data.chunkInfo);
+          }
+        }
+
         try {
           auto response = chunkManager.FetchRasterChunk(data.chunkInfo);
           data.dataset = response.dataset;
@@ -384,104 +512,68 @@ Tin InitializeTinFromBoundary(MeshBoundary boundary, std::string api_key,
           TSR_LOG_ERROR("{}", e.what());
           throw e;
         }
+
+        try {
+          IO::CacheChunk(DEM_FEATURE_ID, data.chunkInfo, data.dataset);
+        } catch (std::exception &e) {
+          TSR_LOG_ERROR("caching chunk failed");
+          TSR_LOG_TRACE("{}", e.what());
+        }
         return data;
       });
 
-  // Step 2: Extract points from the datasets
+  // Step 2: Build an error bounded TIN from each raster
   tbb::flow::function_node<ParallelChunkData, ParallelChunkData>
-      point_extractor_node(
+      tin_builder_node(
           flowGraph, tbb::flow::unlimited,
-          [](ParallelChunkData data) -> ParallelChunkData {
-            //  TSR_LOG_TRACE("Point Extractor node");
+          [&chunkOptions](ParallelChunkData data) -> ParallelChunkData {
+            // TSR_LOG_TRACE("TIN node");
             try {
-              data.points = IO::ExtractGdalDatasetPoints(data.dataset, 1);
+              data.tin = std::make_shared<Tin>(
+                  CreateTinFromDataset(data.dataset, chunkOptions));
             } catch (std::exception &e) {
-              TSR_LOG_ERROR("failed extracting DTM points from dataset");
+              TSR_LOG_ERROR("failed building TIN from dataset");
               TSR_LOG_TRACE("{}", e.what());
               GDALReleaseDataset(data.dataset);
               throw e;
             }
 
             GDALReleaseDataset(data.dataset);
-
-            try {
-              SimplifyPoints(data.points);
-            } catch (std::exception &e) {
-              TSR_LOG_ERROR("failed to simplify points");
-              TSR_LOG_TRACE("{}", e.what());
-              throw e;
-            }
-
             return data;
           });
 
-  tbb::flow::function_node<ParallelChunkData, ParallelChunkData>
-      delaunay_triangulation_node(
-          flowGraph, tbb::flow::unlimited,
-          [](ParallelChunkData data) -> ParallelChunkData {
-            // TSR_LOG_TRACE("TIN node");
-            try {
-              data.tin =
-                  std::make_shared<Tin>(CreateTinFromPoints(data.points));
-            } catch (std::exception &e) {
-              TSR_LOG_ERROR("{}", e.what());
-              throw e;
-            }
-            data.points = {};
-            return data;
-          });
+  // Chunk TINs are only collected here, and merged once all are built
+  tbb::flow::function_node<ParallelChunkData, tbb::flow::continue_msg>
+      collect_node(flowGraph, tbb::flow::serial,
+                   [&chunkTins](ParallelChunkData data) {
+                     // TSR_LOG_TRACE("Collector node");
+                     chunkTins.push_back(data.tin);
+                     return tbb::flow::continue_msg();
+                   });
+
+  tbb::flow::make_edge(input_node, limiter_node);
+  tbb::flow::make_edge(limiter_node, raster_node);
+  tbb::flow::make_edge(raster_node, tin_builder_node);
+  tbb::flow::make_edge(tin_builder_node, collect_node);
+  tbb::flow::make_edge(collect_node, limiter_node.decrementer());
 
-  tbb::flow::function_node<ParallelChunkData, ParallelChunkData> simplify_node(
-      flowGraph, tbb::flow::unlimited,
-      [](ParallelChunkData data) -> ParallelChunkData {
-        try {
-          SimplifyTin(*data.tin, *data.tin);
-        } catch (std::exception &e) {
-          TSR_LOG_ERROR("failed to simplify mesh");
-          TSR_LOG_TRACE("{}", e.what());
-          throw e;
-        }
-        return data;
-      });
-
-  tbb::flow::function_node<ParallelChunkData, ParallelChunkData> cache_node(
-      flowGraph, tbb::flow::unlimited,
-      [](ParallelChunkData data) -> ParallelChunkData {
-        // TSR_LOG_TRACE("Cache node");
-        try {
-          IO::CacheChunk(TIN_FEATURE_ID, data.chunkInfo, *data.tin);
-        } catch (std::exception &e) {
-          TSR_LOG_ERROR("caching chunk failed");
-          TSR_LOG_TRACE("{}", e.what());
-        }
-        return data;
-      });
+  try {
+    input_node.activate();
+    flowGraph.wait_for_all();
+  } catch (std::exception &e) {
+    TSR_LOG_ERROR("{}", e.what());
+    flowGraph.cancel();
+    flowGraph.wait_for_all();
+    throw e;
+  }
 
-  tbb::flow::function_node<ParallelChunkData> collect_node(
-      flowGraph, tbb::flow::serial,
-      [&boundary, &masterTIN](ParallelChunkData data) {
-        // TSR_LOG_TRACE("Collector node");
-        MergeTinPointsInBoundary(boundary, *data.tin, masterTIN);
-      });
+  // Keep the interior of each chunk TIN, and triangulate only the seams
+  Tin masterTIN = StitchChunkTins(chunkTins, boundary);
 
-  tbb::flow::make_edge(input_node, api_node);
-  tbb::flow::make_edge(api_node, point_extractor_node);
-  tbb::flow::make_edge(point_extractor_node, delaunay_triangulation_node);
-  tbb::flow::make_edge(delaunay_triangulation_node, simplify_node);
-  tbb::flow::make_edge(simplify_node, cache_node);
-  tbb::flow::make_edge(cache_node, collect_node);
-
-  if (apiTilesRequired.size() > 0) {
-    try {
-      input_node.activate();
-      flowGraph.wait_for_all();
-    } catch (std::exception &e) {
-      TSR_LOG_ERROR("{}", e.what());
-      flowGraph.cancel();
-      flowGraph.wait_for_all();
-      throw e;
-    }
-  }
+  // Neighbouring chunk rasters may sample almost the same point, leaving
+  // slivers along the seams. Only those near duplicates, and vertices which
+  // don't change the surface at all, are removed, so the error bound holds.
+  SimplifyTin(masterTIN, masterTIN, 1, 0, 1, 0);
 
   TSR_LOG_TRACE("master TIN vertices: {}", masterTIN.number_of_vertices());
   return masterTIN;
@@ -489,19 +581,18 @@ Tin InitializeTinFromBoundary(MeshBoundary boundary, std::string api_key,
 
 void MergeTinPointsInBoundary(MeshBoundary &boundary, const Tin &srcTIN,
                               Tin &dstTIN) {
-  for (auto vertex = srcTIN.all_vertices_begin();
-       vertex != srcTIN.all_vertices_end(); ++vertex) {
 
-    // Skip infinite vertices
-    if (srcTIN.is_infinite(vertex)) {
-      continue;
-    }
+  std::vector<Point3> points;
+  points.reserve(srcTIN.number_of_vertices());
 
-    Point3 point = vertex->point();
+  for (auto vertex : srcTIN.finite_vertex_handles()) {
+    const Point3 &point = vertex->point();
     if (boundary.IsBounded(point)) {
-      dstTIN.insert(point);
+      points.push_back(point);
     }
   }
+
+  InsertPoints(dstTIN, points);
 }
 
 } // namespace tsr
@@ -0,0 +1,235 @@
+#include "tsr/FaceTagger.hpp"
+#include "tsr/ChunkInfo.hpp"
+#include "tsr/Features/RasterFeature.hpp"
+#include "tsr/IO/ChunkCache.hpp"
+#include "tsr/Logging.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/PointProcessor.hpp"
+#include "tsr/RasterTile.hpp"
+#include "tsr/TileCache.hpp"
+#include "tsr/Tin.hpp"
+
+#include <CGAL/Kernel/global_functions_3.h>
+#include <CGAL/Spatial_sort_traits_adapter_2.h>
+#include <CGAL/hilbert_sort.h>
+#include <CGAL/property_map.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <gdal/gdal.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tsr {
+
+/// Orders the faces along a Hilbert curve of their centroids, so that
+/// neighbouring faces are spatially close and mostly share raster tiles
+static void HilbertSortFaces(std::vector<Face_handle> &faces) {
+  typedef std::pair<TIN_K::Point_2, Face_handle> FacePoint;
+  typedef CGAL::First_of_pair_property_map<FacePoint> FacePointMap;
+  typedef CGAL::Spatial_sort_traits_adapter_2<TIN_K, FacePointMap> SortTraits;
+
+  std::vector<FacePoint> facePoints;
+  facePoints.reserve(faces.size());
+
+  for (Face_handle face : faces) {
+    const auto &p0 = face->vertex(0)->point();
+    const auto &p1 = face->vertex(1)->point();
+    const auto &p2 = face->vertex(2)->point();
+
+    TIN_K::Point_2 centroid((p0.x() + p1.x() + p2.x()) / 3,
+                            (p0.y() + p1.y() + p2.y()) / 3);
+    facePoints.emplace_back(centroid, face);
+  }
+
+  CGAL::hilbert_sort(facePoints.begin(), facePoints.end(),
+                     SortTraits(FacePointMap()));
+
+  for (std::size_t i = 0; i < facePoints.size(); i++) {
+    faces[i] = facePoints[i].second;
+  }
+}
+
+std::vector<Face_handle> AssignFaceTagIds(const Tin &tin) {
+
+  std::vector<Face_handle> faces;
+  faces.reserve(tin.number_of_faces());
+  for (Face_handle face : tin.finite_face_handles()) {
+    faces.push_back(face);
+  }
+
+  // Number the faces along a Hilbert curve, so that neighbouring IDs are
+  // spatially close and mostly share raster tiles
+  HilbertSortFaces(faces);
+
+  for (std::size_t i = 0; i < faces.size(); i++) {
+    faces[i]->set_tag_id(static_cast<std::uint32_t>(i));
+  }
+
+  return faces;
+}
+
+std::uint32_t CalculateFaceSignature(Face_handle face) {
+  const std::uint64_t MULTIPLIER = 0x9E3779B97F4A7C15;
+
+  // Sorting the vertex IDs ignores the order of the vertices. IDs are never
+  // reused, so only a hash collision leaves a changed face undetected.
+  std::array<std::uint32_t, 3> ids = {
+      face->vertex(0)->id(), face->vertex(1)->id(), face->vertex(2)->id()};
+  std::sort(ids.begin(), ids.end());
+
+  std::uint64_t signature = 0;
+  for (std::uint32_t id : ids) {
+    signature = (signature ^ id) * MULTIPLIER;
+    signature ^= signature >> 29;
+  }
+
+  return static_cast<std::uint32_t>(signature >> 32);
+}
+
+void FaceTagger::AddFeature(RasterFeature &feature) {
+  this->features.push_back(&feature);
+}
+
+/// The tile a tagging range currently samples for a feature
+struct TileState {
+  ChunkInfo chunk;
+  bool loaded = false;
+  std::shared_ptr<const RasterTile> tile;
+};
+
+void FaceTagger::Tag(const Tin &tin) const { TagAll(tin); }
+
+std::vector<Face_handle> FaceTagger::TagAll(const Tin &tin) const {
+  TSR_LOG_TRACE("Tagging {} raster features", this->features.size());
+
+  const std::vector<Face_handle> faces = AssignFaceTagIds(tin);
+
+  // Discard the tags of the previous numbering
+  for (RasterFeature *feature : this->features) {
+    feature->ResizeTags(0);
+  }
+
+  TagFaces(faces, faces.size());
+  return faces;
+}
+
+std::vector<Face_handle> FaceTagger::Retag(const Tin &tin) const {
+
+  // Find the faces without a tag, or tagged with different vertices
+  std::vector<Face_handle> dirtyFaces;
+  std::size_t faceCount = 0;
+  std::size_t newFaceCount = 0;
+  std::size_t tagCount = 0;
+
+  for (Face_handle face : tin.finite_face_handles()) {
+    faceCount++;
+
+    const std::uint32_t tagID = face->tag_id();
+    if (tagID == TIN_Fb::UNTAGGED) {
+      dirtyFaces.push_back(face);
+      newFaceCount++;
+      continue;
+    }
+
+    tagCount = std::max<std::size_t>(tagCount, tagID + 1);
+    if (face->tag_signature() != CalculateFaceSignature(face)) {
+      dirtyFaces.push_back(face);
+    }
+  }
+
+  TSR_LOG_TRACE("Retagging {} of {} faces", dirtyFaces.size(), faceCount);
+
+  if (dirtyFaces.empty()) {
+    return dirtyFaces;
+  }
+
+  // Removed faces leave their tag IDs unused, so renumber once they would
+  // outnumber the faces
+  if (tagCount + newFaceCount > 2 * faceCount) {
+    TSR_LOG_TRACE("Renumbering face tags");
+    return TagAll(tin);
+  }
+
+  HilbertSortFaces(dirtyFaces);
+
+  // Changed faces keep their tag ID, new faces are numbered after the rest
+  for (Face_handle face : dirtyFaces) {
+    if (face->tag_id() == TIN_Fb::UNTAGGED) {
+      face->set_tag_id(static_cast<std::uint32_t>(tagCount++));
+    }
+  }
+
+  TagFaces(dirtyFaces, tagCount);
+  return dirtyFaces;
+}
+
+void FaceTagger::TagFaces(const std::vector<Face_handle> &faces,
+                          std::size_t tag_count) const {
+
+  std::vector<std::string> cacheIDs;
+  std::vector<GDALDataType> dataTypes;
+  for (RasterFeature *feature : this->features) {
+    feature->ResizeTags(tag_count);
+    cacheIDs.push_back(feature->GetRasterCacheID());
+    dataTypes.push_back(feature->GetRasterDataType());
+  }
+
+  auto tagRange = [&](const tbb::blocked_range<std::size_t> &range) {
+    std::vector<TileState> tiles(this->features.size());
+
+    for (std::size_t f = range.begin(); f != range.end(); ++f) {
+      const Face_handle face = faces[f];
+
+      // Record the vertices the face is tagged with
+      face->set_tag_signature(CalculateFaceSignature(face));
+
+      // Sample each face at its circumcenter
+      auto p0 = face->vertex(0)->point();
+      auto p1 = face->vertex(1)->point();
+      auto p2 = face->vertex(2)->point();
+
+      Point3 center = CGAL::circumcenter(p0, p1, p2);
+
+      Point3 centerWGS84;
+      try {
+        centerWGS84 = TranslateUtmPointToWgs84(center, 30, true);
+      } catch (std::exception &e) {
+        continue;
+      }
+
+      for (std::size_t i = 0; i < this->features.size(); i++) {
+        RasterFeature *feature = this->features[i];
+        TileState &tile = tiles[i];
+
+        ChunkInfo chunk = feature->GetRasterChunkManager().GetChunkInfo(
+            centerWGS84.x(), centerWGS84.y());
+
+        // Switch to the tile covering this face
+        if (!tile.loaded || chunk != tile.chunk) {
+          tile.tile = this->tile_cache->Get(cacheIDs[i], chunk, dataTypes[i]);
+          tile.chunk = chunk;
+          tile.loaded = true;
+        }
+
+        feature->TagFace(face, center, tile.tile.get());
+      }
+    }
+  };
+
+  tbb::blocked_range<std::size_t> allFaces(0, faces.size(), 1024);
+  if (this->parallel) {
+    tbb::parallel_for(allFaces, tagRange);
+  } else {
+    tagRange(allFaces);
+  }
+}
+
+} // namespace tsr
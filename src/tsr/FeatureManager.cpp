@@ -1,5 +1,6 @@
 #include "tsr/FeatureManager.hpp"
 #include "tsr/Feature.hpp"
+#include "tsr/FeatureProfile.hpp"
 #include "tsr/Logging.hpp"
 #include "tsr/Point3.hpp"
 #include "tsr/Tin.hpp"
@@ -8,6 +9,7 @@
 #include <stdexcept>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 namespace tsr {
 
@@ -76,10 +78,58 @@ double FeatureManager::Calculate(TsrState &state) const {
   // TSR_LOG_TRACE("next position: {} {} {}", Pn.x(), Pn.y(), Pn.z());
   // TSR_LOG_TRACE("face id: {}", (void *)&state.current_face);
 
-  return this->outputFeature->Calculate(state);
+  return this->outputFeature->Evaluate(state);
 
   // TSR_LOG_TRACE("cost: {}\n", cost);
   // return cost;
 }
 
-} // namespace tsr
\ No newline at end of file
+#ifdef TSR_PROFILE_FEATURES
+/**
+ * @brief Collects each feature of the graph once, in depth first order
+ *
+ */
+static void
+CollectFeatures(const std::shared_ptr<FeatureBase> &feature,
+                std::unordered_set<const FeatureBase *> &visited,
+                std::vector<std::shared_ptr<FeatureBase>> &features) {
+  if (feature == nullptr || !visited.insert(feature.get()).second) {
+    return;
+  }
+
+  features.push_back(feature);
+  for (const auto &dependency : feature->dependencies) {
+    CollectFeatures(dependency, visited, features);
+  }
+}
+#endif
+
+std::vector<FeatureProfileEntry> FeatureManager::GetProfile() const {
+  std::vector<FeatureProfileEntry> entries;
+
+#ifdef TSR_PROFILE_FEATURES
+  std::unordered_set<const FeatureBase *> visited;
+  std::vector<std::shared_ptr<FeatureBase>> features;
+  CollectFeatures(this->outputFeature, visited, features);
+
+  for (const auto &feature : features) {
+    entries.push_back({feature->feature_id, feature->profile});
+  }
+#endif
+
+  return entries;
+}
+
+void FeatureManager::ResetProfile() const {
+#ifdef TSR_PROFILE_FEATURES
+  std::unordered_set<const FeatureBase *> visited;
+  std::vector<std::shared_ptr<FeatureBase>> features;
+  CollectFeatures(this->outputFeature, visited, features);
+
+  for (const auto &feature : features) {
+    feature->profile.Reset();
+  }
+#endif
+}
+
+} // namespace tsr
@@ -0,0 +1,151 @@
+#include "tsr/FeatureProfile.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tsr {
+
+void FeatureProfile::RecordCall(std::uint64_t call_total_ns,
+                                std::uint64_t call_self_ns) {
+  calls++;
+  total_ns += call_total_ns;
+  self_ns += call_self_ns;
+
+  const std::size_t bucket = std::min<std::size_t>(
+      std::bit_width(call_total_ns), HISTOGRAM_BUCKETS - 1);
+  histogram[bucket]++;
+}
+
+std::uint64_t FeatureProfile::Percentile(double percentile) const {
+  if (calls == 0) {
+    return 0;
+  }
+
+  const double target = percentile * calls;
+
+  std::uint64_t count = 0;
+  for (std::size_t bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+    count += histogram[bucket];
+    if (count >= target && count > 0) {
+      // Bucket b holds durations below 2^b nanoseconds
+      return bucket == 0 ? 0 : std::uint64_t(1) << bucket;
+    }
+  }
+
+  return std::uint64_t(1) << (HISTOGRAM_BUCKETS - 1);
+}
+
+double FeatureProfile::TagLookupHitRate() const {
+  if (lookups == 0) {
+    return 0;
+  }
+  return static_cast<double>(lookup_hits) / lookups;
+}
+
+static void SortBySelfTime(std::vector<FeatureProfileEntry> &entries) {
+  std::sort(entries.begin(), entries.end(),
+            [](const FeatureProfileEntry &a, const FeatureProfileEntry &b) {
+              return a.profile.self_ns > b.profile.self_ns;
+            });
+}
+
+std::string
+FormatFeatureProfileTable(std::vector<FeatureProfileEntry> entries) {
+  if (entries.empty()) {
+    return "no feature profile recorded\n";
+  }
+
+  SortBySelfTime(entries);
+
+  std::uint64_t totalSelf = 0;
+  for (const auto &entry : entries) {
+    totalSelf += entry.profile.self_ns;
+  }
+
+  std::string table =
+      fmt::format("{:<24} {:>12} {:>12} {:>12} {:>7} {:>10} {:>10} {:>10}\n",
+                  "feature", "calls", "total ms", "self ms", "self %",
+                  "p50 ns", "p99 ns", "tag hit %");
+
+  for (const auto &entry : entries) {
+    const FeatureProfile &p = entry.profile;
+
+    std::string hitRate =
+        p.lookups > 0 ? fmt::format("{:.1f}", 100 * p.TagLookupHitRate())
+                      : "-";
+
+    table += fmt::format(
+        "{:<24} {:>12} {:>12.3f} {:>12.3f} {:>7.1f} {:>10} {:>10} {:>10}\n",
+        entry.feature_id, p.calls, p.total_ns / 1e6, p.self_ns / 1e6,
+        totalSelf > 0 ? 100.0 * p.self_ns / totalSelf : 0.0, p.Percentile(0.5),
+        p.Percentile(0.99), hitRate);
+  }
+
+  return table;
+}
+
+/// Escapes a string for use inside a JSON string literal
+static std::string EscapeJsonString(const std::string &value) {
+  std::string escaped;
+  escaped.reserve(value.size());
+
+  for (char c : value) {
+    switch (c) {
+    case '"':
+      escaped += "\\\"";
+      break;
+    case '\\':
+      escaped += "\\\\";
+      break;
+    case '\n':
+      escaped += "\\n";
+      break;
+    case '\r':
+      escaped += "\\r";
+      break;
+    case '\t':
+      escaped += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        escaped += fmt::format("\\u{:04x}", static_cast<int>(c));
+      } else {
+        escaped += c;
+      }
+    }
+  }
+
+  return escaped;
+}
+
+std::string FormatFeatureProfileJson(std::vector<FeatureProfileEntry> entries) {
+  SortBySelfTime(entries);
+
+  std::string json = "[";
+  for (std::size_t i = 0; i < entries.size(); i++) {
+    const FeatureProfile &p = entries[i].profile;
+
+    if (i > 0) {
+      json += ",";
+    }
+
+    json += fmt::format(
+        "\n  {{\"feature\": \"{}\", \"calls\": {}, \"total_ns\": {}, "
+        "\"self_ns\": {}, \"p50_ns\": {}, \"p90_ns\": {}, \"p99_ns\": {}, "
+        "\"lookups\": {}, \"lookup_hits\": {}}}",
+        EscapeJsonString(entries[i].feature_id), p.calls, p.total_ns, p.self_ns,
+        p.Percentile(0.5), p.Percentile(0.9), p.Percentile(0.99), p.lookups,
+        p.lookup_hits);
+  }
+  json += "\n]\n";
+
+  return json;
+}
+
+} // namespace tsr
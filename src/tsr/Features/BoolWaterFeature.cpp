@@ -2,6 +2,7 @@
 #include "tsr/API/GDALHandler.hpp"
 #include "tsr/ChunkInfo.hpp"
 #include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/FaceTagger.hpp"
 #include "tsr/IO/ChunkCache.hpp"
 #include "tsr/IO/FileIO.hpp"
 #include "tsr/IO/KMLWriter.hpp"
@@ -10,16 +11,19 @@
 #include "tsr/Point2.hpp"
 #include "tsr/Point3.hpp"
 #include "tsr/PointProcessor.hpp"
+#include "tsr/RasterTile.hpp"
 #include "tsr/Tin.hpp"
 #include "tsr/TsrState.hpp"
 
 #include <CGAL/Kernel/global_functions_3.h>
 #include <cpl_error.h>
+#include <cstdint>
 #include <exception>
 #include <gdal.h>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace tsr {
@@ -31,184 +35,137 @@ std::string BoolWaterFeature::URL =
     "22%5D%28{}%2C{}%2C{}%2C{}%29%3Bnwr%5B%22natural%22%3D%22coastline%22%5D%"
     "28{}%2C{}%2C{}%2C{}%29%3B);%28._%3B%3E%3B%29%3Bout%20body%3B%0A{}";
 
-void BoolWaterFeature::Initialize(Tin &tin, const MeshBoundary &boundary) {
+void BoolWaterFeature::PrepareData(const MeshBoundary &boundary) {
   auto chunks = chunkManager.GetRequiredChunks(boundary);
 
-  std::string dataFeatureID = this->feature_id + "/data";
-  std::string contourFeatureID = this->feature_id + "/contour";
-
-  const double MAX_SEGMENT_LENGTH = 22;
-
-  // For each chunk, either fetch from the API or cache
-  for (auto chunk : chunks) {
-
-    std::vector<std::vector<Point2>> contours;
-    if (chunkManager.IsAvailableInCache(contourFeatureID, chunk)) {
-
-      IO::GetChunkFromCache<std::vector<std::vector<Point2>>>(contourFeatureID,
-                                                              chunk, contours);
+  auto contours = PrepareChunks(
+      chunks, [this](const ChunkInfo &chunk) { return PrepareChunk(chunk); });
 
-    } else {
-      // Fetch data from api
-      DataFile data;
-      try {
-        data = chunkManager.FetchAndRasterizeVectorChunk(chunk, 0.0001);
-      } catch (std::exception &e) {
-        TSR_LOG_WARN("Failed to fetch chunk or it is empty.");
-        continue;
-      }
+  // Chunks cover far more than the boundary, so only keep the contours inside
+  // it and outside any excluded regions
+  this->prepared_contours =
+      ClipPreparedContours(boundary, std::move(contours));
 
-      // Cache data
-      IO::CacheChunk(dataFeatureID, chunk, data.dataset);
-
-      // Fetch the geotransform for the dataset
-      double adfGeotransform[6];
-      GDALGetGeoTransform(data.dataset, adfGeotransform);
-
-      // Close the dataset to enable the extractor to read
-      GDALReleaseDataset(data.dataset);
-
-      TSR_LOG_TRACE("contour file: {}", data.filename);
-
-      // Extract contours usign OpenCV
-      const double SIMPLIFICATION_FACTOR = 0.001;
-      TSR_LOG_DEBUG("Extracting Contours");
-      contours = API::ExtractFeatureContours(data.filename, adfGeotransform,
-                                             SIMPLIFICATION_FACTOR);
+  TSR_LOG_TRACE("Water Contours: {}", this->prepared_contours.size());
+}
 
-      TSR_LOG_TRACE("chunk contours: {}", contours.size());
+std::vector<std::vector<Point2>>
+BoolWaterFeature::PrepareChunk(const ChunkInfo &chunk) const {
 
-      // Cache contours
-      TSR_LOG_DEBUG("Caching contours ");
-      IO::CacheChunk(contourFeatureID, chunk, contours);
-    }
+  std::string dataFeatureID = this->feature_id + "/data";
+  std::string contourFeatureID = this->feature_id + "/contour";
 
-    TSR_LOG_TRACE("Water Contours: {}", contours.size());
+  // Either fetch from the API or cache
+  std::vector<std::vector<Point2>> contours;
+  if (chunkManager.IsAvailableInCache(contourFeatureID, chunk)) {
 
-    // add contours to mesh
-    for (auto contour : contours) {
-      AddContourConstraint(tin, contour, MAX_SEGMENT_LENGTH);
-    }
+    IO::GetChunkFromCache<std::vector<std::vector<Point2>>>(contourFeatureID,
+                                                            chunk, contours);
+    return contours;
   }
-}
 
-void BoolWaterFeature::Tag(const Tin &tin) {
-  TSR_LOG_TRACE("Tagging water feature");
+  // Fetch data from api
+  DataFile data;
+  try {
+    data = chunkManager.FetchAndRasterizeVectorChunk(chunk, 0.0001);
+  } catch (std::exception &e) {
+    TSR_LOG_WARN("Failed to fetch chunk or it is empty.");
+    return contours;
+  }
 
-  const std::string dataFeatureID = this->feature_id + "/data";
+  // Cache data
+  IO::CacheChunk(dataFeatureID, chunk, data.dataset);
 
-  // Mark whether a face is water or not
-  ChunkInfo dataset_chunk;
-  GDALDatasetH dataset = nullptr;
-  for (Face_handle face : tin.all_face_handles()) {
+  // Fetch the geotransform for the dataset
+  double adfGeotransform[6];
+  GDALGetGeoTransform(data.dataset, adfGeotransform);
 
-    if (tin.is_infinite(face)) {
-      continue;
-    }
+  // Close the dataset to enable the extractor to read
+  GDALReleaseDataset(data.dataset);
 
-    // Get the circumcenter poing
-    auto p0 = face->vertex(0)->point();
-    auto p1 = face->vertex(1)->point();
-    auto p2 = face->vertex(2)->point();
+  TSR_LOG_TRACE("contour file: {}", data.filename);
 
-    Point3 center = CGAL::circumcenter(p0, p1, p2);
+  // Extract contours usign OpenCV
+  const double SIMPLIFICATION_FACTOR = 0.001;
+  TSR_LOG_DEBUG("Extracting Contours");
+  contours = API::ExtractFeatureContours(data.filename, adfGeotransform,
+                                         SIMPLIFICATION_FACTOR);
 
-    Point3 centerWGS84;
-    try {
-      centerWGS84 = TranslateUtmPointToWgs84(center, 30, true);
-    } catch (std::exception &e) {
-      continue;
-    }
+  TSR_LOG_TRACE("chunk contours: {}", contours.size());
 
-    // Get the required chunk
-    ChunkInfo chunk =
-        chunkManager.GetChunkInfo(centerWGS84.x(), centerWGS84.y());
+  // Cache contours
+  TSR_LOG_DEBUG("Caching contours ");
+  IO::CacheChunk(contourFeatureID, chunk, contours);
 
-    if (chunk != dataset_chunk) {
-      if (!IO::IsChunkCached(dataFeatureID, chunk)) {
-        this->waterMap[face] = NODATA;
-        TSR_LOG_WARN("Value not available in cache");
-        continue;
-      }
+  return contours;
+}
 
-      if (dataset != nullptr) {
-        GDALReleaseDataset(dataset);
-      }
+void BoolWaterFeature::AddConstraints(Tin &tin) {
+  const double MAX_SEGMENT_LENGTH = 22;
 
-      IO::GetChunkFromCache<GDALDatasetH>(dataFeatureID, chunk, dataset);
-      dataset_chunk = chunk;
-    }
+  // add contours to mesh
+  AddContourConstraints(tin, this->prepared_contours, MAX_SEGMENT_LENGTH);
 
-    if (dataset == nullptr) {
-      TSR_LOG_ERROR("Water dataset empty");
-      throw std::runtime_error("water dataset empty");
-    }
+  this->prepared_contours.clear();
+}
 
-    // Find the point corresponding to the center of the
-    // Get the GeoTransform
-    double geotransform[6];
-    if (GDALGetGeoTransform(dataset, geotransform) != CE_None) {
-      TSR_LOG_ERROR("Failed to get water GeoTransform");
-      throw std::runtime_error("failed to get water GeoTransform");
-    }
+void BoolWaterFeature::Tag(const Tin &tin) {
+  TSR_LOG_TRACE("Tagging water feature");
 
-    // Check if the coordinates are within the raster bounds
-    int raster_x_size = GDALGetRasterXSize(dataset);
-    int raster_y_size = GDALGetRasterYSize(dataset);
+  FaceTagger tagger;
+  tagger.AddFeature(*this);
+  tagger.Tag(tin);
+}
 
-    // Get the raster band (assuming a single-band GeoTIFF)
-    GDALRasterBandH band =
-        GDALGetRasterBand(dataset, 1); // Use appropriate band if multiple
-    if (band == nullptr) {
-      TSR_LOG_ERROR("Water dataset band not found");
-      throw std::runtime_error("water dataset band not found");
-    }
+std::string BoolWaterFeature::GetRasterCacheID() const {
+  return this->feature_id + "/data";
+}
 
-    // Convert UTM coordinates to pixel coordinates
-    int pixel_x =
-        static_cast<int>((center.x() - geotransform[0]) / geotransform[1]);
-    int pixel_y =
-        static_cast<int>((center.y() - geotransform[3]) / geotransform[5]);
-
-    if (pixel_x < 0 || pixel_x >= raster_x_size || pixel_y < 0 ||
-        pixel_y >= raster_y_size) {
-      TSR_LOG_WARN("Point outside water dataset bounds {} {}", center.x(),
-                   center.y());
-      this->waterMap[face] = NODATA;
-      continue;
-    }
+void BoolWaterFeature::TagFace(Face_handle face, const Point3 &sample,
+                               const RasterTile *tile) {
 
-    // Read the value at the specified pixel
-    float value;
-    if (GDALRasterIO(band, GF_Read, pixel_x, pixel_y, 1, 1, &value, 1, 1,
-                     GDT_Float32, 0, 0) != CE_None) {
-      TSR_LOG_ERROR("Failed to read pixel value from water dataset");
-      throw std::runtime_error("failed to read pixel value from water dataset");
-    }
+  // Mark whether a face is water or not
+  if (tile == nullptr) {
+    this->water_tags[face->tag_id()] = NODATA;
+    return;
+  }
 
-    if (value == NODATA_VALUE) {
-      this->waterMap[face] = NODATA;
-    } else if (value == 0) {
-      this->waterMap[face] = LAND;
-    } else {
-      this->waterMap[face] = WATER;
-    }
+  // Convert UTM coordinates to pixel coordinates
+  int pixel_x;
+  int pixel_y;
+  if (!tile->GetPixel(sample, pixel_x, pixel_y)) {
+    TSR_LOG_WARN("Point outside water dataset bounds {} {}", sample.x(),
+                 sample.y());
+    this->water_tags[face->tag_id()] = NODATA;
+    return;
   }
 
-  if (dataset != nullptr) {
-    GDALReleaseDataset(dataset);
+  // The water raster has a single band
+  float value = tile->Value<float>(0, pixel_x, pixel_y);
+
+  if (value == NODATA_VALUE) {
+    this->water_tags[face->tag_id()] = NODATA;
+  } else if (value == 0) {
+    this->water_tags[face->tag_id()] = LAND;
+  } else {
+    this->water_tags[face->tag_id()] = WATER;
   }
 }
 
-void BoolWaterFeature::WriteWaterToKml() {
+void BoolWaterFeature::WriteWaterToKml(const Tin &tin) const {
   std::vector<Face_handle> waterFaces;
   std::vector<Face_handle> nodataFaces;
 
-  for (auto f : this->waterMap) {
-    if (f.second == WATER) {
-      waterFaces.push_back(f.first);
-    } else if (f.second == NODATA) {
-      nodataFaces.push_back(f.first);
+  for (Face_handle face : tin.finite_face_handles()) {
+    const std::uint32_t tagID = face->tag_id();
+    if (tagID >= this->water_tags.size()) {
+      continue;
+    }
+
+    if (this->water_tags[tagID] == WATER) {
+      waterFaces.push_back(face);
+    } else if (this->water_tags[tagID] == NODATA) {
+      nodataFaces.push_back(face);
     }
   }
 
@@ -220,14 +177,16 @@ void BoolWaterFeature::WriteWaterToKml() {
   IO::WriteDataToFile("water.kml", kml);
 }
 
-bool BoolWaterFeature::Calculate(TsrState &state) {
+template <typename State> bool BoolWaterFeature::CalculateFor(State &state) {
 
-  if (!waterMap.contains(state.current_face)) {
-    AddWarning(state, "water data unavailable", 11);
-    return true;
-  }
+  // Faces created after tagging have no tag
+  WATER_STATUS waterStatus = NODATA;
 
-  auto waterStatus = this->waterMap[state.current_face];
+  const std::uint32_t tagID = state.current_face->tag_id();
+  if (tagID < this->water_tags.size()) {
+    waterStatus = this->water_tags[tagID];
+  }
+  RecordLookup(waterStatus != NODATA);
 
   if (waterStatus == WATER) {
     AddWarning(state, "Water", 11);
@@ -239,4 +198,12 @@ bool BoolWaterFeature::Calculate(TsrState &state) {
     return false;
   }
 }
-} // namespace tsr
\ No newline at end of file
+
+template bool BoolWaterFeature::CalculateFor(TsrState &state);
+template bool
+BoolWaterFeature::CalculateFor(CompactTsrState &state);
+
+bool BoolWaterFeature::Calculate(TsrState &state) {
+  return CalculateFor(state);
+}
+} // namespace tsr
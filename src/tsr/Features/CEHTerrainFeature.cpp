@@ -3,24 +3,29 @@
 #include "tsr/ChunkInfo.hpp"
 #include "tsr/DataFile.hpp"
 #include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/FaceTagger.hpp"
 #include "tsr/IO/ChunkCache.hpp"
 #include "tsr/Logging.hpp"
 #include "tsr/MeshBoundary.hpp"
 #include "tsr/Point2.hpp"
 #include "tsr/Point3.hpp"
 #include "tsr/PointProcessor.hpp"
+#include "tsr/RasterTile.hpp"
 #include "tsr/Tin.hpp"
 #include "tsr/TsrState.hpp"
 
 #include <CGAL/Kernel/global_functions_3.h>
+#include <array>
+#include <boost/filesystem.hpp>
 #include <cpl_error.h>
+#include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <gdal/gdal.h>
-#include <map>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace tsr {
@@ -32,7 +37,14 @@ std::string CEHTerrainFeature::URL =
     "default&BBOX={},{},{},{}&FORMAT=image/"
     "tiff&WIDTH=2048&HEIGHT=2048{}";
 
-std::map<uint32_t, CEH_TERRAIN_TYPE> CEHTerrainFeature::TERRAIN_COLOURS = {
+namespace {
+
+struct TerrainColour {
+  uint32_t colour;
+  CEH_TERRAIN_TYPE type;
+};
+
+constexpr TerrainColour TERRAIN_COLOURS[] = {
     {0xFF0000, BROADLEAVED_MIXED_AND_YEW_WOODLAND},
     {0x006600, CONIFEROUS_WOODLAND},
     {0x732600, ARABLE_AND_HORTICULTURE},
@@ -53,209 +65,291 @@ std::map<uint32_t, CEH_TERRAIN_TYPE> CEHTerrainFeature::TERRAIN_COLOURS = {
     {0xFFFFFF, NO_DATA},
 };
 
-CEH_TERRAIN_TYPE
-CEHTerrainFeature::interpretCEHTerrainColour(std::vector<double> colourValues) {
+/*
+ * Perfect hash of the 24-bit terrain colours into 32 slots. The multiplier
+ * was found by search, and is checked to be collision free at compile time.
+ */
+constexpr uint32_t COLOUR_HASH_MULTIPLIER = 0xCED69CBD;
+constexpr int COLOUR_HASH_BITS = 5;
+constexpr size_t COLOUR_HASH_SLOTS = size_t(1) << COLOUR_HASH_BITS;
 
-  uint32_t colour = (int)colourValues[0] << 16 | (int)colourValues[1] << 8 |
-                    (int)colourValues[2];
+// Not a valid 24-bit colour, so never matches a pixel
+constexpr uint32_t EMPTY_COLOUR_SLOT = UINT32_MAX;
 
-  if (TERRAIN_COLOURS.contains(colour)) {
-    return TERRAIN_COLOURS[colour];
-  } else {
-    TSR_LOG_WARN("terrain colour not recognized ({})", colour);
-    return CEH_TERRAIN_TYPE::NO_DATA;
-  }
+constexpr size_t HashTerrainColour(uint32_t colour) {
+  return (colour * COLOUR_HASH_MULTIPLIER) >> (32 - COLOUR_HASH_BITS);
 }
 
-std::vector<double> CEHTerrainFeature::GetPixelColour(GDALDatasetH dataset,
-                                                      int x, int y) {
-  int rasterXSize = GDALGetRasterXSize(dataset);
-  int rasterYSize = GDALGetRasterYSize(dataset);
+typedef std::array<TerrainColour, COLOUR_HASH_SLOTS> TerrainColourTable;
 
-  if (x < 0 || x >= rasterXSize || y < 0 || y >= rasterYSize) {
-    TSR_LOG_ERROR("point outside raster dataset {} {}", x, y);
-    return std::vector<double>({255, 255, 255});
+constexpr TerrainColourTable CreateTerrainColourTable() {
+  TerrainColourTable table{};
+  for (auto &slot : table) {
+    slot = {EMPTY_COLOUR_SLOT, NO_DATA};
   }
 
-  std::vector<double> colourValues(3);
+  for (const auto &entry : TERRAIN_COLOURS) {
+    table[HashTerrainColour(entry.colour)] = entry;
+  }
 
-  for (int b = 1; b <= 3; b++) {
-    GDALRasterBandH band = GDALGetRasterBand(dataset, b);
-    if (band == nullptr) {
-      TSR_LOG_ERROR("CEH terrain data band not found");
-      throw std::runtime_error("CEH terrain data band not found");
-    }
+  return table;
+}
 
-    if (GDALRasterIO(band, GF_Read, x, y, 1, 1, &colourValues[b - 1], 1, 1,
-                     GDT_Byte, 0, 0) != CE_None) {
-      TSR_LOG_ERROR("failed to get terrain value");
-      throw std::runtime_error("failed to get terrain value");
+constexpr TerrainColourTable TERRAIN_COLOUR_TABLE = CreateTerrainColourTable();
+
+constexpr bool IsTerrainColourHashPerfect() {
+  for (const auto &entry : TERRAIN_COLOURS) {
+    if (TERRAIN_COLOUR_TABLE[HashTerrainColour(entry.colour)].colour !=
+        entry.colour) {
+      return false;
     }
   }
+  return true;
+}
 
-  return colourValues;
+static_assert(IsTerrainColourHashPerfect(),
+              "terrain colour hash has collisions, choose a new multiplier");
+
+// Class codes are stored as a single byte in the cached class raster
+static_assert(NO_DATA <= UINT8_MAX, "terrain classes must fit in a byte");
+
+/// Looks up the terrain type of a colour, which is NO_DATA if unrecognised
+bool LookupTerrainColour(uint32_t colour, CEH_TERRAIN_TYPE &type) {
+  const TerrainColour &slot = TERRAIN_COLOUR_TABLE[HashTerrainColour(colour)];
+  if (slot.colour != colour) {
+    type = CEH_TERRAIN_TYPE::NO_DATA;
+    return false;
+  }
+
+  type = slot.type;
+  return true;
 }
 
-void CEHTerrainFeature::Initialize(Tin &tin, const MeshBoundary &boundary) {
-  TSR_LOG_TRACE("initializing {}", this->feature_id);
+} // namespace
 
-  // Fetch the data from the api
-  auto chunks = chunkManager.GetRequiredChunks(boundary);
+void CEHTerrainFeature::CacheClassRaster(const std::string &cache_id,
+                                         const ChunkInfo &chunk,
+                                         GDALDatasetH rgb_dataset) const {
 
-  std::string dataCacheID = this->feature_id + "/data";
-  std::string contourCacheID = this->feature_id + "/contours";
+  RasterTile rgb(rgb_dataset, GDT_Byte);
 
-  TSR_LOG_TRACE("fetching contours");
-  std::vector<std::vector<Point2>> contours;
+  // Ensure there are RGB bands
+  if (rgb.GetBandCount() < 3) {
+    TSR_LOG_ERROR("CEH terrain dataset not RGB");
+    throw std::runtime_error("CEH terrain dataset not RGB");
+  }
 
-  const double MAX_SEGMENT_SIZE = 22.0;
+  const int width = rgb.GetWidth();
+  const int height = rgb.GetHeight();
 
-  for (auto chunk : chunks) {
+  std::vector<uint8_t> classes(static_cast<size_t>(width) * height);
+  size_t unrecognised = 0;
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      uint32_t colour = rgb.Value<uint8_t>(0, x, y) << 16 |
+                        rgb.Value<uint8_t>(1, x, y) << 8 |
+                        rgb.Value<uint8_t>(2, x, y);
 
-    std::vector<std::vector<Point2>> contours;
-    if (chunkManager.IsAvailableInCache(contourCacheID, chunk)) {
-      IO::GetChunkFromCache<std::vector<std::vector<Point2>>>(contourCacheID,
-                                                              chunk, contours);
-    } else {
+      CEH_TERRAIN_TYPE type;
+      if (!LookupTerrainColour(colour, type)) {
+        unrecognised++;
+      }
+      classes[static_cast<size_t>(y) * width + x] =
+          static_cast<uint8_t>(type);
+    }
+  }
 
-      // Fetch the dataset from either the cache or API
-      DataFile data(nullptr, "");
-      if (IO::IsChunkCached(dataCacheID, chunk)) {
+  // Logging each pixel would flood the log for a badly styled tile
+  if (unrecognised > 0) {
+    TSR_LOG_WARN("{} terrain colours not recognized in chunk ({}, {})",
+                 unrecognised, chunk.minLat, chunk.minLng);
+  }
 
-        data.filename = IO::GetChunkFilepath(dataCacheID, chunk);
-        IO::GetChunkFromCache<GDALDatasetH>(dataCacheID, chunk, data.dataset);
+  // Build the single band class dataset in memory
+  GDALDriverH memDriver = GDALGetDriverByName("MEM");
+  if (memDriver == nullptr) {
+    TSR_LOG_ERROR("MEM GDAL driver not found");
+    throw std::runtime_error("MEM GDAL driver not found");
+  }
 
-      } else {
+  GDALDatasetH classDataset =
+      GDALCreate(memDriver, "", width, height, 1, GDT_Byte, nullptr);
+  if (classDataset == nullptr) {
+    TSR_LOG_ERROR("failed to create CEH class dataset");
+    throw std::runtime_error("failed to create CEH class dataset");
+  }
 
-        // Fech chunk from API
-        TSR_LOG_TRACE("fetching chunk from API");
-        data = chunkManager.FetchRasterChunk(chunk);
+  double adfGeotransform[6];
+  GDALGetGeoTransform(rgb_dataset, adfGeotransform);
+  GDALSetGeoTransform(classDataset, adfGeotransform);
+  GDALSetProjection(classDataset, GDALGetProjectionRef(rgb_dataset));
+
+  if (GDALRasterIO(GDALGetRasterBand(classDataset, 1), GF_Write, 0, 0, width,
+                   height, classes.data(), width, height, GDT_Byte, 0,
+                   0) != CE_None) {
+    GDALClose(classDataset);
+    TSR_LOG_ERROR("failed to write CEH class dataset");
+    throw std::runtime_error("failed to write CEH class dataset");
+  }
 
-        // Cache dataset
-        TSR_LOG_TRACE("caching chunk");
-        try {
-          IO::CacheChunk(dataCacheID, chunk, data.dataset);
-        } catch (std::exception &e) {
-          TSR_LOG_ERROR("failed to cache data");
-          throw e;
-        }
-      }
+  try {
+    IO::CacheChunk(cache_id, chunk, classDataset);
+  } catch (std::exception &e) {
+    GDALClose(classDataset);
+    TSR_LOG_ERROR("failed to cache CEH classes");
+    throw;
+  }
 
-      // Release dataset
+  GDALClose(classDataset);
+}
 
-      double adfGeotransform[6];
-      GDALGetGeoTransform(data.dataset, adfGeotransform);
-      GDALReleaseDataset(data.dataset);
+void CEHTerrainFeature::PrepareData(const MeshBoundary &boundary) {
+  TSR_LOG_TRACE("preparing {}", this->feature_id);
 
-      contours =
-          API::ExtractFeatureContours(data.filename, adfGeotransform, 0.5);
+  auto chunks = chunkManager.GetRequiredChunks(boundary);
 
-      TSR_LOG_TRACE("Caching contours");
-      try {
-        IO::CacheChunk(contourCacheID, chunk, contours);
-      } catch (std::exception &e) {
-        TSR_LOG_WARN("failed to cache CEH contours");
-      }
-    }
+  auto contours = PrepareChunks(
+      chunks, [this](const ChunkInfo &chunk) { return PrepareChunk(chunk); });
 
-    TSR_LOG_TRACE("CEH Contours: {}", contours.size());
+  // Chunks cover far more than the boundary, so only keep the contours inside
+  // it and outside any excluded regions
+  this->prepared_contours =
+      ClipPreparedContours(boundary, std::move(contours));
 
-    // Add contours to the mesh
-    for (auto contour : contours) {
-      AddContourConstraint(tin, contour, MAX_SEGMENT_SIZE);
-    }
-  }
-};
+  TSR_LOG_TRACE("CEH Contours: {}", this->prepared_contours.size());
+}
 
-void CEHTerrainFeature::Tag(const Tin &tin) {
-  TSR_LOG_TRACE("Tagging CEH terrain type feature");
+std::vector<std::vector<Point2>>
+CEHTerrainFeature::PrepareChunk(const ChunkInfo &chunk) const {
 
+  // RGB tiles are only kept in the cache by older versions
   std::string dataCacheID = this->feature_id + "/data";
+  std::string classCacheID = this->GetRasterCacheID();
+  std::string contourCacheID = this->feature_id + "/contours";
 
-  GDALDatasetH dataset = nullptr;
-  ChunkInfo dataset_chunk;
-  for (Face_handle face : tin.all_face_handles()) {
+  std::vector<std::vector<Point2>> contours;
+  bool haveContours = chunkManager.IsAvailableInCache(contourCacheID, chunk);
+  bool haveClasses = chunkManager.IsAvailableInCache(classCacheID, chunk);
 
-    if (tin.is_infinite(face)) {
-      continue;
-    }
+  if (haveContours) {
+    IO::GetChunkFromCache<std::vector<std::vector<Point2>>>(contourCacheID,
+                                                            chunk, contours);
+  }
+
+  if (haveContours && haveClasses) {
+    return contours;
+  }
 
-    auto p0 = face->vertex(0)->point();
-    auto p1 = face->vertex(1)->point();
-    auto p2 = face->vertex(2)->point();
+  // Fetch the RGB dataset from either a legacy cache entry or the API
+  DataFile data(nullptr, "");
+  bool fromCache = IO::IsChunkCached(dataCacheID, chunk);
+  if (fromCache) {
 
-    Point3 center = CGAL::circumcenter(p0, p1, p2);
+    data.filename = IO::GetChunkFilepath(dataCacheID, chunk);
+    IO::GetChunkFromCache<GDALDatasetH>(dataCacheID, chunk, data.dataset);
 
-    Point3 centerWGS84;
+  } else {
+
+    // Fech chunk from API
+    TSR_LOG_TRACE("fetching chunk from API");
+    data = chunkManager.FetchRasterChunk(chunk);
+  }
+
+  if (!haveClasses) {
+    TSR_LOG_TRACE("caching CEH classes");
     try {
-      centerWGS84 = TranslateUtmPointToWgs84(center, 30, true);
+      CacheClassRaster(classCacheID, chunk, data.dataset);
     } catch (std::exception &e) {
-      continue;
+      GDALReleaseDataset(data.dataset);
+      throw;
     }
+  }
 
-    ChunkInfo chunk =
-        chunkManager.GetChunkInfo(centerWGS84.x(), centerWGS84.y());
+  // Release dataset
 
-    if (chunk != dataset_chunk && IO::IsChunkCached(dataCacheID, chunk)) {
+  double adfGeotransform[6];
+  GDALGetGeoTransform(data.dataset, adfGeotransform);
+  GDALReleaseDataset(data.dataset);
 
-      if (dataset != nullptr) {
-        GDALReleaseDataset(dataset);
-      }
+  if (!haveContours) {
+    contours = API::ExtractFeatureContours(data.filename, adfGeotransform, 0.5);
 
-      IO::GetChunkFromCache<GDALDatasetH>(dataCacheID, chunk, dataset);
-      dataset_chunk = chunk;
-    } else {
-      continue;
+    TSR_LOG_TRACE("Caching contours");
+    try {
+      IO::CacheChunk(contourCacheID, chunk, contours);
+    } catch (std::exception &e) {
+      TSR_LOG_WARN("failed to cache CEH contours");
     }
+  }
 
-    if (dataset == nullptr) {
-      TSR_LOG_ERROR("CEH terrain type dataset empty");
-      throw std::runtime_error("CEH terrain type dataset empty");
-    }
+  // Fetched RGB tiles are no longer needed once decoded. Legacy cache entries
+  // are left for the user to clear.
+  if (!fromCache) {
+    boost::filesystem::remove(data.filename);
+  }
 
-    // Ensure there are RGB bands
-    // TSR_LOG_TRACE("Checking feature dataset RGB");
-    int bandCount = GDALGetRasterCount(dataset);
-    if (bandCount < 3) {
-      TSR_LOG_ERROR("CEH terrain dataset not RGB");
-      throw std::runtime_error("CEH terrain dataset not RGB");
-    }
+  return contours;
+}
 
-    // TSR_LOG_TRACE("getting dataset information");
+void CEHTerrainFeature::AddConstraints(Tin &tin) {
+  const double MAX_SEGMENT_SIZE = 22.0;
 
-    // Tag each face with a terrain feature
-    double geotransform[6];
-    if (GDALGetGeoTransform(dataset, geotransform) != CE_None) {
-      TSR_LOG_ERROR("failed to get terrain type GeoTransform");
-      throw std::runtime_error("failed to get terrain type GeoTransform");
-    }
+  // Add contours to the mesh
+  AddContourConstraints(tin, this->prepared_contours, MAX_SEGMENT_SIZE);
+
+  this->prepared_contours.clear();
+}
+
+void CEHTerrainFeature::Tag(const Tin &tin) {
+  TSR_LOG_TRACE("Tagging CEH terrain type feature");
+
+  FaceTagger tagger;
+  tagger.AddFeature(*this);
+  tagger.Tag(tin);
+}
+
+std::string CEHTerrainFeature::GetRasterCacheID() const {
+  return this->feature_id + "/classes";
+}
 
-    int pixel_x =
-        static_cast<int>((center.x() - geotransform[0]) / geotransform[1]);
-    int pixel_y =
-        static_cast<int>((center.y() - geotransform[3]) / geotransform[5]);
+void CEHTerrainFeature::TagFace(Face_handle face, const Point3 &sample,
+                                const RasterTile *tile) {
 
-    // TSR_LOG_TRACE("getting colour value");
-    auto colourValues = GetPixelColour(dataset, pixel_x, pixel_y);
+  // Faces without a cached tile are treated as NO_DATA
+  if (tile == nullptr) {
+    this->terrain_tags[face->tag_id()] = CEH_TERRAIN_TYPE::NO_DATA;
+    return;
+  }
 
-    // TSR_LOG_TRACE("interpreting and setting colour value");
-    this->terrain_map[face] = interpretCEHTerrainColour(colourValues);
+  int pixel_x;
+  int pixel_y;
+  if (!tile->GetPixel(sample, pixel_x, pixel_y)) {
+    TSR_LOG_ERROR("point outside raster dataset {} {}", sample.x(),
+                  sample.y());
+    this->terrain_tags[face->tag_id()] = CEH_TERRAIN_TYPE::NO_DATA;
+    return;
   }
 
-  if (dataset != nullptr) {
-    GDALReleaseDataset(dataset);
+  // Class raster holds the decoded CEH_TERRAIN_TYPE of each pixel
+  uint8_t terrainClass = tile->Value<uint8_t>(0, pixel_x, pixel_y);
+  if (terrainClass > CEH_TERRAIN_TYPE::NO_DATA) {
+    terrainClass = CEH_TERRAIN_TYPE::NO_DATA;
   }
+
+  this->terrain_tags[face->tag_id()] =
+      static_cast<CEH_TERRAIN_TYPE>(terrainClass);
 }
 
-double CEHTerrainFeature::Calculate(TsrState &state) {
+template <typename State> double CEHTerrainFeature::CalculateFor(State &state) {
 
-  CEH_TERRAIN_TYPE type;
+  // Faces created after tagging have no tag
+  CEH_TERRAIN_TYPE type = CEH_TERRAIN_TYPE::NO_DATA;
 
-  if (this->terrain_map.contains(state.current_face)) {
-    type = this->terrain_map[state.current_face];
-  } else {
-    type = CEH_TERRAIN_TYPE::NO_DATA;
+  const std::uint32_t tagID = state.current_face->tag_id();
+  if (tagID < this->terrain_tags.size()) {
+    type = this->terrain_tags[tagID];
   }
+  RecordLookup(type != CEH_TERRAIN_TYPE::NO_DATA);
 
   switch (type) {
   case BROADLEAVED_MIXED_AND_YEW_WOODLAND:
@@ -291,4 +385,12 @@ double CEHTerrainFeature::Calculate(TsrState &state) {
   }
 }
 
+template double CEHTerrainFeature::CalculateFor(TsrState &state);
+template double
+CEHTerrainFeature::CalculateFor(CompactTsrState &state);
+
+double CEHTerrainFeature::Calculate(TsrState &state) {
+  return CalculateFor(state);
+}
+
 } // namespace tsr
\ No newline at end of file
@@ -16,7 +16,7 @@ double MultiplierFeature::Calculate(TsrState &state) {
     switch (this->dependency_types[f->feature_id]) {
     case INT: {
       auto feature = std::dynamic_pointer_cast<Feature<int>>(f);
-      int value = feature->Calculate(state);
+      int value = feature->Evaluate(state);
 
       if (total == std::numeric_limits<double>::infinity() ||
           ((double)value) == std::numeric_limits<double>::infinity()) {
@@ -29,7 +29,7 @@ double MultiplierFeature::Calculate(TsrState &state) {
     }
     case DOUBLE: {
       auto feature = std::dynamic_pointer_cast<Feature<double>>(f);
-      double value = feature->Calculate(state);
+      double value = feature->Evaluate(state);
 
       if (total == std::numeric_limits<double>::infinity() ||
           value == std::numeric_limits<double>::infinity()) {
@@ -42,7 +42,7 @@ double MultiplierFeature::Calculate(TsrState &state) {
     }
     case BOOL: {
       auto feature = std::dynamic_pointer_cast<Feature<bool>>(f);
-      bool value = feature->Calculate(state);
+      bool value = feature->Evaluate(state);
       if (value) {
         break;
       } else {
@@ -1,8 +1,8 @@
 #include "tsr/Features/PathFeature.hpp"
 #include "tsr/ChunkInfo.hpp"
 #include "tsr/DelaunayTriangulation.hpp"
-#include "tsr/Features/BoolWaterFeature.hpp"
 #include "tsr/IO/ChunkCache.hpp"
+#include "tsr/IO/KMLWriter.hpp"
 #include "tsr/IO/JSONParser.hpp"
 #include "tsr/Logging.hpp"
 #include "tsr/MeshBoundary.hpp"
@@ -10,114 +10,270 @@
 #include "tsr/Point3.hpp"
 #include "tsr/Tin.hpp"
 #include "tsr/TsrState.hpp"
+#include <algorithm>
+#include <boost/functional/hash.hpp>
 #include <cmath>
 #include <cstddef>
 #include <exception>
+#include <fstream>
 #include <gdal.h>
 #include <memory>
+#include <set>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 namespace tsr {
 
-std::size_t EdgeHash::operator()(const std::pair<Point3, Point3> &edge) const {
-  size_t seed = 0;
-  boost::hash_combine(seed, edge.first.x());
-  boost::hash_combine(seed, edge.first.y());
-  boost::hash_combine(seed, edge.second.x());
-  boost::hash_combine(seed, edge.second.y());
-  return seed;
-}
-
 std::string PathFeature::URL =
     "https://lz4.overpass-api.de/api/"
     "interpreter?data=%5Bout%3Axml%5D%5Btimeout%3A25%5D%3B%28way%5B%22highway%"
     "22%5D%28{},{},{},{}%29%3B%29%3B%28._%3B%3E%3B%29%3Bout+body%"
     "3B%0A{}";
 
-std::pair<Point3, Point3> PathFeature::NormalizeSegmentOrder(Point3 p1,
-                                                             Point3 p2) {
-
-  // Lexicographical ordering on coords
-  bool retainOrder;
-  if (p1.x() < p2.x()) {
-    retainOrder = true;
-  } else if (p1.x() > p2.x()) {
-    retainOrder = false;
-  } else if (p1.y() < p2.y()) {
-    retainOrder = true;
-  } else if (p1.y() > p2.y()) {
-    retainOrder = false;
-  } else if (p1.z() < p2.z()) {
-    retainOrder = true;
-  } else {
-    retainOrder = false;
+void PathFeature::PrepareData(const MeshBoundary &boundary) {
+  auto chunks = chunkManager.GetRequiredChunks(boundary);
+
+  auto contours = PrepareChunks(
+      chunks, [this](const ChunkInfo &chunk) { return PrepareChunk(chunk); });
+
+  // Chunks cover far more than the boundary, so only keep the contours inside
+  // it and outside any excluded regions
+  this->prepared_contours =
+      ClipPreparedContours(boundary, std::move(contours));
+
+  TSR_LOG_TRACE("Path Contours: {}", this->prepared_contours.size());
+}
+
+std::vector<std::vector<Point2>>
+PathFeature::PrepareChunk(const ChunkInfo &chunk) const {
+
+  // Check if the paths are cached
+  std::vector<std::vector<Point2>> contours;
+  if (chunkManager.IsAvailableInCache(this->feature_id, chunk)) {
+    // Contours are cached
+    IO::GetChunkFromCache<std::vector<std::vector<Point2>>>(this->feature_id,
+                                                            chunk, contours);
+    return contours;
   }
 
-  if (retainOrder) {
-    return {p1, p2};
-  } else {
-    return {p2, p1};
+  // Download from API
+  auto data = chunkManager.FetchVectorChunk(chunk);
+  GDALReleaseDataset(data.dataset);
+
+  contours = IO::LoadContoursFromJsonFile(data.filename, "features");
+
+  // Cache Contours
+  try {
+    IO::CacheChunk(this->feature_id, chunk, contours);
+  } catch (std::exception &e) {
+    TSR_LOG_WARN("failed to cache path contours");
   }
+
+  return contours;
 }
 
-void PathFeature::Initialize(Tin &tin, const MeshBoundary &boundary) {
-  auto chunks = chunkManager.GetRequiredChunks(boundary);
+void PathFeature::AddConstraints(Tin &tin) {
   const double MAX_SEGMENT_SIZE = 15;
 
-  // Check if the paths are cached
-  std::vector<std::vector<Point2>> contours;
-  for (auto chunk : chunks) {
-
-    if (chunkManager.IsAvailableInCache(this->feature_id, chunk)) {
-      // Contours are cached
-      IO::GetChunkFromCache<std::vector<std::vector<Point2>>>(this->feature_id,
-                                                              chunk, contours);
-    } else {
-      // Download from API
-      auto data = chunkManager.FetchVectorChunk(chunk);
-      // IO::CacheChunk("test", chunk, data.dataset);
-      GDALReleaseDataset(data.dataset);
-
-      contours = IO::LoadContoursFromJsonFile(data.filename, "features");
-
-      // Cache Contours
-      try {
-        IO::CacheChunk(this->feature_id, chunk, contours);
-      } catch (std::exception &e) {
-        TSR_LOG_WARN("failed to cache path contours");
-      }
+  auto constraints =
+      AddContourConstraints(tin, this->prepared_contours, MAX_SEGMENT_SIZE);
+
+  // Growing the mesh may insert a segment again where contours overlap, so
+  // only keep segments not already marked, in either direction
+  std::set<std::pair<Point3, Point3>> knownSegments;
+  for (const auto &segment : this->path_segments) {
+    knownSegments.insert(std::minmax(segment.first, segment.second));
+  }
+
+  for (const auto &segment : constraints) {
+    if (knownSegments.insert(std::minmax(segment.first, segment.second))
+            .second) {
+      this->path_segments.push_back(segment);
     }
+  }
+
+  this->prepared_contours.clear();
 
-    TSR_LOG_TRACE("Path Contours: {}", contours.size());
+  TSR_LOG_TRACE("Total Paths: {}", path_segments.size());
+}
+
+void PathFeature::MarkPathEdge(const Tin &tin, Face_handle face, int index) {
+  face->set_path(index, true);
+
+  // Mark the same edge on the adjacent face
+  Face_handle neighbor = face->neighbor(index);
+  neighbor->set_path(tin.mirror_index(face, index), true);
+}
 
-    for (auto contour : contours) {
-      auto constraints = AddContourConstraint(tin, contour, MAX_SEGMENT_SIZE);
+size_t PathFeature::MarkPathSegment(const Tin &tin,
+                                    const std::pair<Point3, Point3> &segment,
+                                    Face_handle &hint) {
+  Tin::Locate_type locateType;
+  int locateIndex;
+
+  // Find the vertices the path segment was inserted between
+  Face_handle sourceFace =
+      tin.locate(segment.first, locateType, locateIndex, hint);
+  if (locateType != Tin::VERTEX) {
+    return 0;
+  }
+  Vertex_handle source = sourceFace->vertex(locateIndex);
+
+  Face_handle targetFace =
+      tin.locate(segment.second, locateType, locateIndex, sourceFace);
+  if (locateType != Tin::VERTEX) {
+    return 0;
+  }
+  Vertex_handle target = targetFace->vertex(locateIndex);
+  hint = targetFace;
+
+  // Later constraints may have split the segment, so walk each of the
+  // collinear edges between the source and target
+  size_t pathEdges = 0;
+  Vertex_handle next;
+  Face_handle face;
+  int index;
+  while (source != target &&
+         tin.includes_edge(source, target, next, face, index)) {
+    MarkPathEdge(tin, face, index);
+    source = next;
+    pathEdges++;
+  }
+
+  return pathEdges;
+}
 
-      for (auto constraint : constraints) {
-        this->paths.insert(
-            NormalizeSegmentOrder(constraint.first, constraint.second));
+void PathFeature::Tag(const Tin &tin) {
+  TSR_LOG_TRACE("Tagging path feature");
+
+  size_t pathEdges = 0;
+  Face_handle hint;
+  for (const auto &segment : this->path_segments) {
+    pathEdges += MarkPathSegment(tin, segment, hint);
+  }
+
+  TSR_LOG_TRACE("Path edges: {}", pathEdges);
+}
+
+namespace {
+
+/// Side of the grid cells used to find the segments near changed faces
+constexpr double RETAG_CELL_SIZE = 50;
+
+typedef std::pair<long, long> RetagCell;
+
+/// Calls the function on each grid cell overlapping the bounding box
+template <typename Function>
+void ForEachCell(double min_x, double min_y, double max_x, double max_y,
+                 Function function) {
+  long minX = std::floor(min_x / RETAG_CELL_SIZE);
+  long minY = std::floor(min_y / RETAG_CELL_SIZE);
+  long maxX = std::floor(max_x / RETAG_CELL_SIZE);
+  long maxY = std::floor(max_y / RETAG_CELL_SIZE);
+
+  for (long x = minX; x <= maxX; x++) {
+    for (long y = minY; y <= maxY; y++) {
+      if (function(RetagCell(x, y))) {
+        return;
       }
     }
   }
-
-  TSR_LOG_TRACE("Total Paths: {}", paths.size());
 }
 
-bool PathFeature::Calculate(TsrState &state) {
+} // namespace
+
+void PathFeature::Retag(const Tin &tin,
+                        const std::vector<Face_handle> &changed_faces) {
+
+  // Mark the cells each changed face may have path edges in. Edges of
+  // unchanged faces keep their marks, as marking is idempotent.
+  std::unordered_set<RetagCell, boost::hash<RetagCell>> changedCells;
+  for (Face_handle face : changed_faces) {
+    face->clear_paths();
+
+    const Point3 &a = face->vertex(0)->point();
+    const Point3 &b = face->vertex(1)->point();
+    const Point3 &c = face->vertex(2)->point();
+    ForEachCell(std::min({a.x(), b.x(), c.x()}),
+                std::min({a.y(), b.y(), c.y()}),
+                std::max({a.x(), b.x(), c.x()}),
+                std::max({a.y(), b.y(), c.y()}), [&](const RetagCell &cell) {
+                  changedCells.insert(cell);
+                  return false;
+                });
+  }
+
+  // Only segments whose bounding box meets a changed face can have edges on
+  // it, so the rest are not located again
+  size_t pathEdges = 0;
+  size_t remarked = 0;
+  Face_handle hint;
+  for (const auto &segment : this->path_segments) {
+    const Point3 &a = segment.first;
+    const Point3 &b = segment.second;
+
+    bool nearChange = false;
+    ForEachCell(std::min(a.x(), b.x()), std::min(a.y(), b.y()),
+                std::max(a.x(), b.x()), std::max(a.y(), b.y()),
+                [&](const RetagCell &cell) {
+                  nearChange = changedCells.contains(cell);
+                  return nearChange;
+                });
+
+    if (nearChange) {
+      pathEdges += MarkPathSegment(tin, segment, hint);
+      remarked++;
+    }
+  }
 
-  const Point3 source_point = state.current_vertex->point();
-  const Point3 target_point = state.next_vertex->point();
+  TSR_LOG_TRACE("Re-marked {} of {} path segments ({} edges)", remarked,
+                this->path_segments.size(), pathEdges);
+}
 
-  const std::pair<Point3, Point3> segment =
-      NormalizeSegmentOrder(source_point, target_point);
+template <typename State> bool PathFeature::CalculateFor(State &state) {
 
-  if (this->paths.contains(segment)) {
-    return true;
-  } else {
+  const auto face = state.current_face;
+  if (face == nullptr) {
     return false;
   }
+
+  // The edge being traversed is opposite the remaining vertex of the face
+  const int edgeIndex =
+      3 - face->index(state.current_vertex) - face->index(state.next_vertex);
+
+  return face->is_path(edgeIndex);
+}
+
+template bool PathFeature::CalculateFor(TsrState &state);
+template bool PathFeature::CalculateFor(CompactTsrState &state);
+
+bool PathFeature::Calculate(TsrState &state) { return CalculateFor(state); }
+
+void PathFeature::WritePathsToKml(const Tin &tin) const {
+  std::ofstream file("path.kml");
+  if (!file) {
+    TSR_LOG_WARN("failed to open path KML file");
+    return;
+  }
+
+  IO::WriteKmlDocumentStart(file);
+
+  for (auto edge = tin.finite_edges_begin(); edge != tin.finite_edges_end();
+       ++edge) {
+    const Face_handle face = edge->first;
+    const int index = edge->second;
+
+    if (!face->is_path(index)) {
+      continue;
+    }
+
+    IO::WriteKmlLine(file, face->vertex(Tin::ccw(index))->point(),
+                     face->vertex(Tin::cw(index))->point());
+  }
+
+  IO::WriteKmlDocumentEnd(file);
 }
 
 } // namespace tsr
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "tsr/Features/TabulatedFeature.hpp"
+#include "tsr/Feature.hpp"
+#include "tsr/Logging.hpp"
+#include "tsr/TsrState.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tsr {
+
+TabulatedFeature::TabulatedFeature(std::string name, Curve curve, double min_x,
+                                   double max_x, std::size_t samples)
+    : Feature<double>(name), min_x(min_x), max_x(max_x) {
+
+  if (samples < 2 || !(max_x > min_x)) {
+    TSR_LOG_ERROR("invalid tabulated feature range");
+    throw std::runtime_error("invalid tabulated feature range");
+  }
+
+  const double step = (max_x - min_x) / (samples - 1);
+  this->inverse_step = 1 / step;
+
+  this->table.resize(samples);
+  for (std::size_t i = 0; i < samples; i++) {
+    this->table[i] = curve(min_x + i * step);
+  }
+}
+
+double TabulatedFeature::SolvePolynomial(
+    double x, const std::vector<double> &coefficients) {
+
+  // Horner's method, highest degree first
+  double y = 0;
+  for (auto it = coefficients.rbegin(); it != coefficients.rend(); ++it) {
+    y = y * x + *it;
+  }
+
+  return y;
+}
+
+TabulatedFeature::Curve
+TabulatedFeature::Polynomial(std::vector<double> coefficients) {
+  return [coefficients](double x) { return SolvePolynomial(x, coefficients); };
+}
+
+TabulatedFeature::Curve
+TabulatedFeature::Piecewise(std::vector<std::pair<double, Curve>> pieces) {
+
+  if (pieces.empty()) {
+    TSR_LOG_ERROR("piecewise curve requires at least one piece");
+    throw std::runtime_error("piecewise curve requires at least one piece");
+  }
+
+  std::sort(pieces.begin(), pieces.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+
+  return [pieces](double x) {
+    for (const auto &piece : pieces) {
+      if (x <= piece.first) {
+        return piece.second(x);
+      }
+    }
+    return pieces.back().second(x);
+  };
+}
+
+TabulatedFeature::Curve
+TabulatedFeature::Measured(std::vector<std::pair<double, double>> samples) {
+
+  if (samples.empty()) {
+    TSR_LOG_ERROR("measured curve requires at least one sample");
+    throw std::runtime_error("measured curve requires at least one sample");
+  }
+
+  std::sort(samples.begin(), samples.end());
+
+  return [samples](double x) {
+    if (x <= samples.front().first) {
+      return samples.front().second;
+    }
+    if (x >= samples.back().first) {
+      return samples.back().second;
+    }
+
+    // Find the first sample beyond x and interpolate from the previous one
+    auto upper = std::upper_bound(
+        samples.begin(), samples.end(), x,
+        [](double value, const auto &sample) { return value < sample.first; });
+    auto lower = std::prev(upper);
+
+    const double t = (x - lower->first) / (upper->first - lower->first);
+    return lower->second + t * (upper->second - lower->second);
+  };
+}
+
+double TabulatedFeature::Calculate(TsrState &state) {
+  auto inputFeature =
+      std::dynamic_pointer_cast<Feature<double>>(this->dependencies[X]);
+
+  return Lookup(inputFeature->Evaluate(state));
+}
+
+} // namespace tsr
@@ -1,6 +1,5 @@
 #include "tsr/IO/KMLWriter.hpp"
 #include "fmt/core.h"
-#include "tsr/Features/GradientSpeedFeature.hpp"
 #include "tsr/IO/FileIO.hpp"
 #include "tsr/Logging.hpp"
 #include "tsr/Point3.hpp"
@@ -11,6 +10,8 @@
 #include <boost/dynamic_bitset/dynamic_bitset.hpp>
 #include <chrono>
 #include <ctime>
+#include <ostream>
+#include <sstream>
 #include <string>
 
 #include <fmt/chrono.h>
@@ -49,19 +50,25 @@ void writeFailureStateToKML(const std::string &filepath, TsrState &state) {
 
 std::string GenerateKmlDocument(const std::string &inner_kml) {
 
-  std::string kml;
+  std::ostringstream kml;
 
-  kml += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-  kml += "<kml xmlns=\"http://www.opengis.net/kml/2.2\">\n";
-  kml += "<Document>\n";
-  kml += "  <name>TSR Router</name>\n";
+  WriteKmlDocumentStart(kml);
+  kml << inner_kml;
+  WriteKmlDocumentEnd(kml);
 
-  kml += inner_kml;
+  return kml.str();
+}
 
-  kml += "</Document>\n";
-  kml += "</kml>\n";
+void WriteKmlDocumentStart(std::ostream &stream) {
+  stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+  stream << "<kml xmlns=\"http://www.opengis.net/kml/2.2\">\n";
+  stream << "<Document>\n";
+  stream << "  <name>TSR Router</name>\n";
+}
 
-  return kml;
+void WriteKmlDocumentEnd(std::ostream &stream) {
+  stream << "</Document>\n";
+  stream << "</kml>\n";
 }
 
 std::string GenerateKmlFaces(std::vector<Face_handle> &faces,
@@ -169,33 +176,36 @@ std::string GenerateKmlWarnings(const TsrState &state) {
 
 std::string GenerateKmlLine(std::pair<Point3, Point3> line) {
 
-  std::string kml = "";
+  std::ostringstream kml;
+  WriteKmlLine(kml, line.first, line.second);
 
-  kml += "<Placemark>\n";
-  kml += "<LineString>\n";
-  kml += "<altitudeMode>clampToGround</altitudeMode>\n";
-  kml += "<coordinates>\n";
+  return kml.str();
+}
 
-  auto sourcePointWGS84 = TranslateUtmPointToWgs84(line.first, 30, true);
-  auto targetPointWGS84 = TranslateUtmPointToWgs84(line.second, 30, true);
-  kml += std::to_string(sourcePointWGS84.y()) + "," +
-         std::to_string(sourcePointWGS84.x()) + "," + "0\n";
-  kml += std::to_string(targetPointWGS84.y()) + "," +
-         std::to_string(targetPointWGS84.x()) + "," + "0\n";
+void WriteKmlLine(std::ostream &stream, const Point3 &source,
+                  const Point3 &target) {
 
-  kml += "</coordinates>\n";
-  kml += "</LineString>\n";
-  kml += "</Placemark>\n";
+  auto sourcePointWGS84 = TranslateUtmPointToWgs84(source, 30, true);
+  auto targetPointWGS84 = TranslateUtmPointToWgs84(target, 30, true);
 
-  return kml;
+  stream << "<Placemark>\n";
+  stream << "<LineString>\n";
+  stream << "<altitudeMode>clampToGround</altitudeMode>\n";
+  stream << "<coordinates>\n";
+
+  stream << std::to_string(sourcePointWGS84.y()) << ","
+         << std::to_string(sourcePointWGS84.x()) << ",0\n";
+  stream << std::to_string(targetPointWGS84.y()) << ","
+         << std::to_string(targetPointWGS84.x()) << ",0\n";
+
+  stream << "</coordinates>\n";
+  stream << "</LineString>\n";
+  stream << "</Placemark>\n";
 }
 
 std::string GenerateKmlRoute(const std::vector<Point3> &route,
                              const double duration) {
 
-  // Used to show gradient
-  GradientSpeedFeature Fg("gradient");
-
   if (route.empty()) {
     TSR_LOG_WARN("Route empty");
     return "";
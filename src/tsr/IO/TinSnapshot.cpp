@@ -0,0 +1,372 @@
+#include "tsr/IO/TinSnapshot.hpp"
+#include "tsr/FaceTagger.hpp"
+#include "tsr/Logging.hpp"
+#include "tsr/Point3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tsr::IO {
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'T', 'S', 'R', 'S', 'N', 'A', 'P', '\0'};
+constexpr std::uint32_t SNAPSHOT_VERSION = 3;
+
+/// The arrays follow the header in order: vertex_count SnapshotVertex,
+/// face_count SnapshotFace, tag_count bytes for each raster feature, then
+/// segment_count SnapshotSegment. Index 0 is the infinite vertex.
+struct SnapshotHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t feature_count;
+  std::uint64_t vertex_count;
+  std::uint64_t face_count;
+  std::uint64_t tag_count;
+  std::uint64_t segment_count;
+
+  /// Width, height, angle and midpoint of the boundary
+  double boundary[5];
+};
+
+struct SnapshotVertex {
+  double x;
+  double y;
+  double z;
+  std::uint32_t face;
+  std::uint32_t padding;
+};
+
+/// Tag signatures depend on the vertices of this process, so are calculated
+/// again on loading rather than stored
+struct SnapshotFace {
+  std::uint32_t vertices[3];
+  std::uint32_t neighbors[3];
+  std::uint32_t tag_id;
+  std::uint8_t constraint_mask;
+  std::uint8_t path_mask;
+  std::uint8_t padding[2];
+};
+
+/// Path segment, which may be unaligned as it follows the tags
+struct SnapshotSegment {
+  double source[3];
+  double target[3];
+};
+
+void GetBoundaryValues(const MeshBoundary &boundary, double values[5]) {
+  values[0] = boundary.width;
+  values[1] = boundary.height;
+  values[2] = boundary.angle;
+  values[3] = boundary.midpoint.x();
+  values[4] = boundary.midpoint.y();
+}
+
+/// Read-only mapping of a whole file, unmapped on destruction
+class MappedFile {
+private:
+  const std::uint8_t *data = nullptr;
+  std::size_t size = 0;
+
+public:
+  explicit MappedFile(const std::string &filepath) {
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+      void *mapped =
+          mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapped != MAP_FAILED) {
+        data = static_cast<const std::uint8_t *>(mapped);
+        size = info.st_size;
+      }
+    }
+
+    // The mapping stays valid once the file is closed
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if (data != nullptr) {
+      munmap(const_cast<std::uint8_t *>(data), size);
+    }
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool IsOpen() const { return data != nullptr; }
+  const std::uint8_t *Data() const { return data; }
+  std::size_t Size() const { return size; }
+};
+
+void ThrowMalformed(const std::string &filepath) {
+  TSR_LOG_ERROR("malformed TIN snapshot {}", filepath);
+  throw std::runtime_error("malformed TIN snapshot");
+}
+
+} // namespace
+
+bool WriteTinSnapshot(const std::string &filepath, const Tin &tin,
+                      const MeshBoundary &boundary,
+                      const std::vector<const RasterFeature *> &features,
+                      const std::vector<PathSegment> &path_segments) {
+
+  if (tin.dimension() != 2) {
+    TSR_LOG_ERROR("cannot snapshot a TIN of dimension {}", tin.dimension());
+    return false;
+  }
+
+  // Number the vertices and faces, with the infinite vertex first
+  std::unordered_map<Vertex_handle, std::uint32_t> vertexIndex;
+  vertexIndex[tin.infinite_vertex()] = 0;
+  for (Vertex_handle vertex : tin.finite_vertex_handles()) {
+    vertexIndex.emplace(vertex, vertexIndex.size());
+  }
+
+  std::unordered_map<Face_handle, std::uint32_t> faceIndex;
+  for (Face_handle face : tin.all_face_handles()) {
+    faceIndex.emplace(face, faceIndex.size());
+  }
+
+  // Features tagged by the same tagger have a tag for each tag ID. Padding
+  // would need each feature's own untagged value, so mismatches are refused.
+  std::vector<std::vector<std::uint8_t>> featureTags;
+  for (const RasterFeature *feature : features) {
+    featureTags.push_back(feature->ExportTags());
+  }
+  std::size_t tagCount = featureTags.empty() ? 0 : featureTags[0].size();
+  for (const auto &tags : featureTags) {
+    if (tags.size() != tagCount) {
+      TSR_LOG_ERROR("cannot snapshot features with {} and {} tags", tagCount,
+                    tags.size());
+      return false;
+    }
+  }
+
+  SnapshotHeader header = {};
+  std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+  header.version = SNAPSHOT_VERSION;
+  header.feature_count = features.size();
+  header.vertex_count = vertexIndex.size();
+  header.face_count = faceIndex.size();
+  header.tag_count = tagCount;
+  header.segment_count = path_segments.size();
+  GetBoundaryValues(boundary, header.boundary);
+
+  std::vector<SnapshotVertex> vertices(vertexIndex.size());
+  for (const auto &[vertex, index] : vertexIndex) {
+    SnapshotVertex &out = vertices[index];
+    if (index != 0) {
+      out.x = vertex->point().x();
+      out.y = vertex->point().y();
+      out.z = vertex->point().z();
+    }
+    out.face = faceIndex.at(vertex->face());
+  }
+
+  std::vector<SnapshotFace> faces(faceIndex.size());
+  for (const auto &[face, index] : faceIndex) {
+    SnapshotFace &out = faces[index];
+    for (int i = 0; i < 3; i++) {
+      out.vertices[i] = vertexIndex.at(face->vertex(i));
+      out.neighbors[i] = faceIndex.at(face->neighbor(i));
+      out.constraint_mask |= face->is_constrained(i) << i;
+      out.path_mask |= face->is_path(i) << i;
+    }
+    out.tag_id = face->tag_id();
+  }
+
+  // Write beside the snapshot and rename it into place, so an interrupted
+  // write never leaves a partial snapshot to be loaded
+  std::string tmpFilepath = filepath + ".tmp";
+  {
+    std::ofstream file(tmpFilepath, std::ios::binary);
+    if (!file) {
+      TSR_LOG_ERROR("failed to open TIN snapshot {}", tmpFilepath);
+      return false;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(vertices.data()),
+               vertices.size() * sizeof(SnapshotVertex));
+    file.write(reinterpret_cast<const char *>(faces.data()),
+               faces.size() * sizeof(SnapshotFace));
+    for (const auto &tags : featureTags) {
+      file.write(reinterpret_cast<const char *>(tags.data()), tags.size());
+    }
+    for (const PathSegment &segment : path_segments) {
+      SnapshotSegment out = {
+          {segment.first.x(), segment.first.y(), segment.first.z()},
+          {segment.second.x(), segment.second.y(), segment.second.z()}};
+      file.write(reinterpret_cast<const char *>(&out), sizeof(out));
+    }
+
+    file.close();
+    if (!file) {
+      TSR_LOG_ERROR("failed to write TIN snapshot {}", tmpFilepath);
+      std::remove(tmpFilepath.c_str());
+      return false;
+    }
+  }
+
+  if (std::rename(tmpFilepath.c_str(), filepath.c_str()) != 0) {
+    TSR_LOG_ERROR("failed to move TIN snapshot into place at {}", filepath);
+    std::remove(tmpFilepath.c_str());
+    return false;
+  }
+
+  TSR_LOG_TRACE("wrote snapshot of {} vertices and {} faces",
+                vertices.size(), faces.size());
+  return true;
+}
+
+bool LoadTinSnapshot(const std::string &filepath, const MeshBoundary &boundary,
+                     Tin &tin, const std::vector<RasterFeature *> &features,
+                     std::vector<PathSegment> &path_segments) {
+
+  MappedFile file(filepath);
+  if (!file.IsOpen()) {
+    TSR_LOG_TRACE("no TIN snapshot at {}", filepath);
+    return false;
+  }
+
+  if (file.Size() < sizeof(SnapshotHeader)) {
+    ThrowMalformed(filepath);
+  }
+
+  SnapshotHeader header;
+  std::memcpy(&header, file.Data(), sizeof(header));
+  if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+    ThrowMalformed(filepath);
+  }
+
+  if (header.version != SNAPSHOT_VERSION) {
+    TSR_LOG_WARN("TIN snapshot {} has version {}, expected {}", filepath,
+                 header.version, SNAPSHOT_VERSION);
+    return false;
+  }
+
+  // Boundaries built from the same points are computed identically
+  double boundaryValues[5];
+  GetBoundaryValues(boundary, boundaryValues);
+  bool sameBoundary = std::memcmp(header.boundary, boundaryValues,
+                                  sizeof(boundaryValues)) == 0;
+  if (!sameBoundary || header.feature_count != features.size()) {
+    TSR_LOG_WARN("TIN snapshot {} was written for another region", filepath);
+    return false;
+  }
+
+  std::size_t verticesOffset = sizeof(SnapshotHeader);
+  std::size_t facesOffset =
+      verticesOffset + header.vertex_count * sizeof(SnapshotVertex);
+  std::size_t tagsOffset =
+      facesOffset + header.face_count * sizeof(SnapshotFace);
+  std::size_t segmentsOffset =
+      tagsOffset + header.feature_count * header.tag_count;
+  if (header.vertex_count == 0 || header.face_count == 0 ||
+      file.Size() !=
+          segmentsOffset + header.segment_count * sizeof(SnapshotSegment)) {
+    ThrowMalformed(filepath);
+  }
+
+  const auto *vertices =
+      reinterpret_cast<const SnapshotVertex *>(file.Data() + verticesOffset);
+  const auto *faces =
+      reinterpret_cast<const SnapshotFace *>(file.Data() + facesOffset);
+
+  // Rebuild the data structure directly, as the snapshot already holds a
+  // valid triangulation
+  Tin snapshotTin;
+  auto &tds = snapshotTin.tds();
+  tds.clear();
+  tds.set_dimension(2);
+
+  std::vector<Vertex_handle> vertexHandles(header.vertex_count);
+  for (std::size_t i = 0; i < header.vertex_count; i++) {
+    vertexHandles[i] = tds.create_vertex();
+    if (i != 0) {
+      vertexHandles[i]->set_point(
+          Point3(vertices[i].x, vertices[i].y, vertices[i].z));
+    }
+  }
+
+  std::vector<Face_handle> faceHandles(header.face_count);
+  for (std::size_t i = 0; i < header.face_count; i++) {
+    const SnapshotFace &face = faces[i];
+    for (int j = 0; j < 3; j++) {
+      if (face.vertices[j] >= header.vertex_count ||
+          face.neighbors[j] >= header.face_count) {
+        ThrowMalformed(filepath);
+      }
+    }
+
+    faceHandles[i] = tds.create_face(vertexHandles[face.vertices[0]],
+                                     vertexHandles[face.vertices[1]],
+                                     vertexHandles[face.vertices[2]]);
+  }
+
+  for (std::size_t i = 0; i < header.face_count; i++) {
+    const SnapshotFace &face = faces[i];
+    Face_handle handle = faceHandles[i];
+    handle->set_neighbors(faceHandles[face.neighbors[0]],
+                          faceHandles[face.neighbors[1]],
+                          faceHandles[face.neighbors[2]]);
+
+    for (int j = 0; j < 3; j++) {
+      handle->set_constraint(j, (face.constraint_mask >> j) & 1);
+      handle->set_path(j, (face.path_mask >> j) & 1);
+    }
+    handle->set_tag_id(face.tag_id);
+  }
+
+  for (std::size_t i = 0; i < header.vertex_count; i++) {
+    if (vertices[i].face >= header.face_count) {
+      ThrowMalformed(filepath);
+    }
+    vertexHandles[i]->set_face(faceHandles[vertices[i].face]);
+  }
+
+  // Faces keep their tags, so are signed with the vertices just created
+  for (Face_handle face : faceHandles) {
+    face->set_tag_signature(CalculateFaceSignature(face));
+  }
+
+  snapshotTin.set_infinite_vertex(vertexHandles[0]);
+  tin.swap(snapshotTin);
+
+  for (std::size_t i = 0; i < features.size(); i++) {
+    features[i]->ImportTags(file.Data() + tagsOffset + i * header.tag_count,
+                            header.tag_count);
+  }
+
+  path_segments.resize(header.segment_count);
+  for (std::size_t i = 0; i < header.segment_count; i++) {
+    SnapshotSegment segment;
+    std::memcpy(&segment,
+                file.Data() + segmentsOffset + i * sizeof(SnapshotSegment),
+                sizeof(segment));
+    path_segments[i] = {
+        Point3(segment.source[0], segment.source[1], segment.source[2]),
+        Point3(segment.target[0], segment.target[1], segment.target[2])};
+  }
+
+  TSR_LOG_TRACE("loaded snapshot of {} vertices and {} faces",
+                header.vertex_count, header.face_count);
+  return true;
+}
+
+} // namespace tsr::IO
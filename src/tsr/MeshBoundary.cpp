@@ -1,7 +1,11 @@
 #include "tsr/MeshBoundary.hpp"
 #include "tsr/Point2.hpp"
 #include "tsr/Point3.hpp"
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <utility>
 #include <vector>
 
 #include "tsr/Logging.hpp"
@@ -125,7 +129,7 @@ bool MeshBoundary::IsBoundedSafe(const Point3 &p) const {
   double halfWidth = width / 2.0;
   double halfHeight = height / 2.0;
 
-  double SAFE_DISTANCE_M = 30;
+  double SAFE_DISTANCE_M = BOUNDARY_SAFE_DISTANCE;
 
   bool withinBounds =
       (rotatedPoint.x() >= this->midpoint.x() - halfWidth + SAFE_DISTANCE_M &&
@@ -152,6 +156,209 @@ void MeshBoundary::FilterPointsOutsideBoundary(
   points.swap(filteredPoints);
 }
 
+/**
+ * @brief Liang-Barsky clipping of the segment p + t * d, for t in [0, 1],
+ * against the rectangle centred on the origin. Narrows t0 and t1 to the part
+ * of the segment inside it, returning false if there is none.
+ */
+static bool ClipSegment(const Point2 &p, double dx, double dy,
+                        double half_width, double half_height, double &t0,
+                        double &t1) {
+  const double edgeP[4] = {-dx, dx, -dy, dy};
+  const double edgeQ[4] = {p.x() + half_width, half_width - p.x(),
+                           p.y() + half_height, half_height - p.y()};
+
+  t0 = 0;
+  t1 = 1;
+  for (int i = 0; i < 4; i++) {
+    if (edgeP[i] == 0) {
+      // Parallel to the edge, so either entirely inside or outside it
+      if (edgeQ[i] < 0) {
+        return false;
+      }
+      continue;
+    }
+
+    const double t = edgeQ[i] / edgeP[i];
+    if (edgeP[i] < 0) {
+      t0 = std::max(t0, t);
+    } else {
+      t1 = std::min(t1, t);
+    }
+
+    if (t0 > t1) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::vector<std::vector<Point2>>
+MeshBoundary::SplitContour(const std::vector<Point2> &contour,
+                           bool keep_inside) const {
+
+  std::vector<std::vector<Point2>> pieces;
+  if (contour.size() < 2) {
+    return pieces;
+  }
+
+  const double halfWidth = this->width / 2.0;
+  const double halfHeight = this->height / 2.0;
+  const double s = std::sin(-this->angle);
+  const double c = std::cos(-this->angle);
+
+  // Contour points in the boundary's frame, centred on the midpoint
+  auto toLocal = [&](const Point2 &p) {
+    double x = p.x() - this->midpoint.x();
+    double y = p.y() - this->midpoint.y();
+    return Point2(x * c - y * s, x * s + y * c);
+  };
+
+  std::vector<Point2> piece;
+  Point2 nextLocal = toLocal(contour[0]);
+
+  for (size_t i = 1; i < contour.size(); i++) {
+    const Point2 local = nextLocal;
+    nextLocal = toLocal(contour[i]);
+    const double dx = nextLocal.x() - local.x();
+    const double dy = nextLocal.y() - local.y();
+
+    // Points are kept exactly, only cut points are rotated back into place
+    auto cutPoint = [&](double t) {
+      return rotatePoint(Point2(local.x() + t * dx + this->midpoint.x(),
+                                local.y() + t * dy + this->midpoint.y()),
+                         this->midpoint, this->angle);
+    };
+
+    double t0;
+    double t1;
+    const bool crosses =
+        ClipSegment(local, dx, dy, halfWidth, halfHeight, t0, t1);
+
+    if (keep_inside) {
+      if (!crosses) {
+        continue;
+      }
+
+      if (piece.empty()) {
+        piece.push_back(t0 > 0 ? cutPoint(t0) : contour[i - 1]);
+      }
+      piece.push_back(t1 < 1 ? cutPoint(t1) : contour[i]);
+
+      // The contour leaves the boundary, so end the piece
+      if (t1 < 1) {
+        pieces.push_back(std::move(piece));
+        piece.clear();
+      }
+      continue;
+    }
+
+    if (!crosses) {
+      if (piece.empty()) {
+        piece.push_back(contour[i - 1]);
+      }
+      piece.push_back(contour[i]);
+      continue;
+    }
+
+    // The contour enters the boundary, so end the piece
+    if (t0 > 0) {
+      if (piece.empty()) {
+        piece.push_back(contour[i - 1]);
+      }
+      piece.push_back(cutPoint(t0));
+      pieces.push_back(std::move(piece));
+      piece.clear();
+    }
+
+    // The contour leaves the boundary, so start a new piece
+    if (t1 < 1) {
+      piece.push_back(cutPoint(t1));
+      piece.push_back(contour[i]);
+    }
+  }
+
+  if (piece.size() > 1) {
+    pieces.push_back(std::move(piece));
+  }
+
+  return pieces;
+}
+
+std::vector<std::vector<Point2>>
+MeshBoundary::ClipContour(const std::vector<Point2> &contour) const {
+  return SplitContour(contour, true);
+}
+
+std::vector<std::vector<Point2>>
+MeshBoundary::SubtractContour(const std::vector<Point2> &contour) const {
+  return SplitContour(contour, false);
+}
+
+std::vector<std::vector<Point2>> MeshBoundary::ClipContours(
+    const std::vector<std::vector<Point2>> &contours) const {
+
+  std::vector<std::vector<Point2>> clipped;
+  for (const auto &contour : contours) {
+    auto pieces = ClipContour(contour);
+    clipped.insert(clipped.end(), std::make_move_iterator(pieces.begin()),
+                   std::make_move_iterator(pieces.end()));
+  }
+
+  TSR_LOG_TRACE("Clipped {} contours into {} pieces", contours.size(),
+                clipped.size());
+
+  return clipped;
+}
+
+std::vector<std::vector<Point2>> MeshBoundary::SubtractContours(
+    const std::vector<std::vector<Point2>> &contours) const {
+
+  std::vector<std::vector<Point2>> remaining;
+  for (const auto &contour : contours) {
+    auto pieces = SubtractContour(contour);
+    remaining.insert(remaining.end(), std::make_move_iterator(pieces.begin()),
+                     std::make_move_iterator(pieces.end()));
+  }
+
+  TSR_LOG_TRACE("Subtracted {} contours into {} pieces", contours.size(),
+                remaining.size());
+
+  return remaining;
+}
+
+double MeshBoundary::DistanceFromAxis(const Point2 &p) const {
+  Point2 rotatedPoint = rotatePoint(p, this->midpoint, -this->angle);
+
+  // The boundary extends half the radius beyond each end of the axis
+  double halfLength = (width - height / 2.0) / 2.0;
+
+  double dx = std::max(
+      0.0, std::abs(rotatedPoint.x() - this->midpoint.x()) - halfLength);
+  double dy = rotatedPoint.y() - this->midpoint.y();
+
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+bool MeshBoundary::ContainsSafe(const MeshBoundary &other) const {
+  double halfWidth = other.width / 2.0 - BOUNDARY_SAFE_DISTANCE;
+  double halfHeight = other.height / 2.0 - BOUNDARY_SAFE_DISTANCE;
+
+  // Both regions are convex, so the other is contained if its corners are
+  for (int sx : {-1, 1}) {
+    for (int sy : {-1, 1}) {
+      Point2 corner(other.midpoint.x() + sx * halfWidth,
+                    other.midpoint.y() + sy * halfHeight);
+      if (!IsBounded(rotatePoint(corner, other.midpoint, other.angle))) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 Point2 MeshBoundary::GetLowerLeftPoint() const {
   // Calculate the lower left corner
   return this->ll;
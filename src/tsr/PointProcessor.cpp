@@ -67,28 +67,6 @@ void JetSmoothPoints(std::vector<Point3> &points) {
                                                               nb_neighbors);
 }
 
-void SimplifyPoints(std::vector<Point3> &points) {
-
-  points.erase(CGAL::hierarchy_simplify_point_set(
-                   points,
-                   CGAL::parameters::size(22)      // Max cluster size
-                       .maximum_variation(0.001)), // Max surface variation
-               points.end());
-
-  // parameters
-  const double retain_percentage = 70; // percentage of points to retain.
-  const double neighbor_radius = 30;   // neighbors size.
-
-  std::vector<Point3> points_simplified;
-
-  CGAL::wlop_simplify_and_regularize_point_set<CGAL::Parallel_if_available_tag>(
-      points, std::back_inserter(points_simplified),
-      CGAL::parameters::select_percentage(retain_percentage)
-          .neighbor_radius(neighbor_radius));
-
-  points = points_simplified;
-}
-
 double CalculateXYAngle(const Point3 &p1, const Point3 &p2) {
   return std::atan2(p2.y() - p1.y(), p2.x() - p1.x());
 }
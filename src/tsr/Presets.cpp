@@ -9,9 +9,14 @@
  *
  */
 
+#include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/FaceTagger.hpp"
 #include "tsr/FeatureManager.hpp"
+#include "tsr/IO/TinSnapshot.hpp"
 #include "tsr/Logging.hpp"
 #include "tsr/MeshBoundary.hpp"
+#include "tsr/PresetFeatures.hpp"
+#include "tsr/Presets.hpp"
 #include "tsr/Tin.hpp"
 
 #include "tsr/Features/BoolWaterFeature.hpp"
@@ -26,124 +31,166 @@
 #include "tsr/Features/PathFeature.hpp"
 
 #include <memory>
+#include <string>
+#include <tbb/parallel_invoke.h>
+#include <utility>
+#include <vector>
 
 namespace tsr {
-FeatureManager SetupTimePreset(Tin &tin, const MeshBoundary &boundary) {
 
-  // Feature Manager Configuration
-  TSR_LOG_TRACE("Setting up feature manager");
-  FeatureManager fm;
+PresetFeatures CreatePresetFeatures() {
 
-  TSR_LOG_DEBUG("Constructors");
+  TSR_LOG_TRACE("Setting up preset features");
+  PresetFeatures features;
 
   auto gradientFeature = std::make_shared<GradientFeature>("gradient");
-  auto distance = std::make_shared<DistanceFeature>("distance");
-  auto gradientSpeedInfluence =
+  features.gradient_speed =
       std::make_shared<GradientSpeedFeature>("gradient_speed");
-  gradientSpeedInfluence->AddDependency(gradientFeature);
+  features.gradient_speed->AddDependency(gradientFeature);
 
-  auto terrainFeature =
-      std::make_shared<CEHTerrainFeature>("terrain_type", 0.1);
+  features.terrain = std::make_shared<CEHTerrainFeature>("terrain_type", 0.1);
+  features.water = std::make_shared<BoolWaterFeature>("water", 0.1);
+  features.paths = std::make_shared<PathFeature>("paths", 0.05);
 
-  auto waterFeature = std::make_shared<BoolWaterFeature>("water", 0.1);
+  return features;
+}
 
-  auto pathFeature = std::make_shared<PathFeature>("paths", 0.05);
+void PreparePresetFeatureData(const PresetFeatures &features,
+                              const MeshBoundary &boundary) {
+  TSR_LOG_DEBUG("Preparing feature data");
+  tbb::parallel_invoke([&] { features.terrain->PrepareData(boundary); },
+                       [&] { features.water->PrepareData(boundary); },
+                       [&] { features.paths->PrepareData(boundary); });
+}
 
-  auto waterSpeedInfluence =
-      std::make_shared<InverseFeature<bool, bool>>("water_speed");
-  waterSpeedInfluence->AddDependency(waterFeature);
+void ApplyPresetFeatures(Tin &tin, const PresetFeatures &features) {
 
-  auto speedFeature = std::make_shared<MultiplierFeature>("speed");
-  speedFeature->AddDependency(waterSpeedInfluence, MultiplierFeature::BOOL);
-  speedFeature->AddDependency(terrainFeature, MultiplierFeature::DOUBLE);
-  speedFeature->AddDependency(gradientSpeedInfluence,
-                              MultiplierFeature::DOUBLE);
+  // Constraints must be inserted into the mesh one at a time
+  TSR_LOG_DEBUG("Terrain");
+  features.terrain->AddConstraints(tin);
+  TSR_LOG_DEBUG("Water");
+  features.water->AddConstraints(tin);
+  TSR_LOG_DEBUG("Paths");
+  features.paths->AddConstraints(tin);
 
-  auto pathSpeed = std::make_shared<MultiplierFeature>("path_speed");
-  pathSpeed->AddDependency(gradientSpeedInfluence, MultiplierFeature::DOUBLE);
+  // Tag the raster features in a single pass over the faces
+  TSR_LOG_DEBUG("Tagging");
+  FaceTagger tagger;
+  tagger.AddFeature(*features.terrain);
+  tagger.AddFeature(*features.water);
+  tagger.Tag(tin);
 
-  auto speedWithPathFeature =
-      std::make_shared<ConditionalFeature<double>>("speed_with_path");
-  speedWithPathFeature->AddDependency(pathFeature);
-  speedWithPathFeature->AddDependency(pathSpeed);
-  speedWithPathFeature->AddDependency(speedFeature);
+  features.paths->Tag(tin);
 
-  auto inverseSpeedFeature =
-      std::make_shared<InverseFeature<double, double>>("inverse_speed");
-  inverseSpeedFeature->AddDependency(speedWithPathFeature);
+  // Write water and paths to KML
+  features.water->WriteWaterToKml(tin);
+  features.paths->WritePathsToKml(tin);
+}
 
-  auto timeFeature = std::make_shared<MultiplierFeature>("time");
-  timeFeature->AddDependency(distance, MultiplierFeature::DOUBLE);
-  timeFeature->AddDependency(inverseSpeedFeature, MultiplierFeature::DOUBLE);
+PresetFeatures SetupPresetFeatures(Tin &tin, const MeshBoundary &boundary) {
+  PresetFeatures features = CreatePresetFeatures();
 
-  fm.SetOutputFeature(timeFeature);
+  PreparePresetFeatureData(features, boundary);
+  ApplyPresetFeatures(tin, features);
 
-  TSR_LOG_TRACE("initializing features");
+  return features;
+}
 
-  TSR_LOG_DEBUG("Terrain");
-  terrainFeature->Initialize(tin, boundary);
-  TSR_LOG_DEBUG("Water");
-  waterFeature->Initialize(tin, boundary);
-  TSR_LOG_DEBUG("Paths");
-  pathFeature->Initialize(tin, boundary);
+PresetFeatures
+SetupTinWithPresetFeatures(Tin &tin, const MeshBoundary &boundary,
+                           const std::string &api_key,
+                           const ChunkPipelineOptions &pipeline_options) {
+  PresetFeatures features = CreatePresetFeatures();
+
+  // The DEM and feature data are independent until constraints are inserted,
+  // so fetch and process both at once
+  TSR_LOG_DEBUG("Initializing TIN and preparing feature data");
+  tbb::parallel_invoke(
+      [&] {
+        Tin initialTin = InitializeTinFromBoundary(
+            boundary, api_key, DEFAULT_DEM_URL_FORMAT, TinBuilderOptions(),
+            pipeline_options);
+        tin.swap(initialTin);
+      },
+      [&] { PreparePresetFeatureData(features, boundary); });
+
+  TSR_LOG_TRACE("Vertices: {}", tin.number_of_vertices());
+
+  ApplyPresetFeatures(tin, features);
+
+  return features;
+}
 
-  TSR_LOG_DEBUG("Tagging");
-  terrainFeature->Tag(tin);
-  waterFeature->Tag(tin);
-  pathFeature->Tag(tin);
+void RetagPresetFeatures(const Tin &tin, const PresetFeatures &features) {
+  TSR_LOG_DEBUG("Retagging changed faces");
 
-  // Write water and paths to KML
-  waterFeature->WriteWaterToKml();
-  pathFeature->WritePathsToKml();
+  FaceTagger tagger;
+  tagger.AddFeature(*features.terrain);
+  tagger.AddFeature(*features.water);
+  auto changedFaces = tagger.Retag(tin);
 
-  return fm;
+  features.paths->Retag(tin, changedFaces);
 }
 
-FeatureManager SetupTimeWithSwimmingPreset(Tin &tin,
-                                           const MeshBoundary &boundary) {
+bool WritePresetSnapshot(const std::string &filepath, const Tin &tin,
+                         const MeshBoundary &boundary,
+                         const PresetFeatures &features) {
+  TSR_LOG_DEBUG("Writing snapshot {}", filepath);
+
+  // Paths are stored on the TIN faces, with their segments kept so they can
+  // be marked again once the TIN changes
+  return IO::WriteTinSnapshot(filepath, tin, boundary,
+                              {features.terrain.get(), features.water.get()},
+                              features.paths->GetPathSegments());
+}
+
+bool LoadPresetSnapshot(const std::string &filepath,
+                        const MeshBoundary &boundary, Tin &tin,
+                        PresetFeatures &features) {
+  PresetFeatures snapshotFeatures = CreatePresetFeatures();
+
+  std::vector<IO::PathSegment> pathSegments;
+  if (!IO::LoadTinSnapshot(
+          filepath, boundary, tin,
+          {snapshotFeatures.terrain.get(), snapshotFeatures.water.get()},
+          pathSegments)) {
+    return false;
+  }
+  snapshotFeatures.paths->SetPathSegments(std::move(pathSegments));
+
+  TSR_LOG_DEBUG("Loaded snapshot {}", filepath);
+  features = snapshotFeatures;
+  return true;
+}
+
+/**
+ * @brief Composes the time cost graph shared by the time presets, given the
+ * influence of water on speed.
+ *
+ */
+static FeatureManager
+SetupTimeGraph(const PresetFeatures &features,
+               std::shared_ptr<FeatureBase> waterSpeedInfluence,
+               MultiplierFeature::DEPENDENCY_TYPE waterSpeedType) {
 
   // Feature Manager Configuration
   TSR_LOG_TRACE("Setting up feature manager");
   FeatureManager fm;
 
-  TSR_LOG_DEBUG("Constructors");
-
-  auto gradientFeature = std::make_shared<GradientFeature>("gradient");
   auto distance = std::make_shared<DistanceFeature>("distance");
-  auto gradientSpeedInfluence =
-      std::make_shared<GradientSpeedFeature>("gradient_speed");
-  gradientSpeedInfluence->AddDependency(gradientFeature);
-
-  auto terrainFeature =
-      std::make_shared<CEHTerrainFeature>("terrain_type", 0.1);
-
-  auto waterFeature = std::make_shared<BoolWaterFeature>("water", 0.1);
-
-  auto pathFeature = std::make_shared<PathFeature>("paths", 0.05);
-
-  auto swimSpeed = std::make_shared<ConstantFeature<double>>("swimSpeed", 0.89);
-  auto noImpact = std::make_shared<ConstantFeature<double>>("swimSpeed", 1);
-  auto waterSpeedInfluence =
-      std::make_shared<ConditionalFeature<double>>("water_speed");
-  // If water
-  waterSpeedInfluence->AddDependency(waterFeature);
-  // Then swimspeed
-  waterSpeedInfluence->AddDependency(swimSpeed);
-  // Else, don't impact speed
-  waterSpeedInfluence->AddDependency(noImpact);
 
   auto speedFeature = std::make_shared<MultiplierFeature>("speed");
-  speedFeature->AddDependency(waterSpeedInfluence, MultiplierFeature::DOUBLE);
-  speedFeature->AddDependency(terrainFeature, MultiplierFeature::DOUBLE);
-  speedFeature->AddDependency(gradientSpeedInfluence,
+  speedFeature->AddDependency(waterSpeedInfluence, waterSpeedType);
+  speedFeature->AddDependency(features.terrain, MultiplierFeature::DOUBLE);
+  speedFeature->AddDependency(features.gradient_speed,
                               MultiplierFeature::DOUBLE);
 
   auto pathSpeed = std::make_shared<MultiplierFeature>("path_speed");
-  pathSpeed->AddDependency(gradientSpeedInfluence, MultiplierFeature::DOUBLE);
+  pathSpeed->AddDependency(features.gradient_speed, MultiplierFeature::DOUBLE);
 
   auto speedWithPathFeature =
       std::make_shared<ConditionalFeature<double>>("speed_with_path");
-  speedWithPathFeature->AddDependency(pathFeature);
+  speedWithPathFeature->AddDependency(features.paths);
   speedWithPathFeature->AddDependency(pathSpeed);
   speedWithPathFeature->AddDependency(speedFeature);
 
@@ -157,105 +204,65 @@ FeatureManager SetupTimeWithSwimmingPreset(Tin &tin,
 
   fm.SetOutputFeature(timeFeature);
 
-  TSR_LOG_TRACE("initializing features");
-
-  TSR_LOG_DEBUG("Terrain");
-  terrainFeature->Initialize(tin, boundary);
-  TSR_LOG_DEBUG("Water");
-  waterFeature->Initialize(tin, boundary);
-  TSR_LOG_DEBUG("Paths");
-  pathFeature->Initialize(tin, boundary);
-
-  TSR_LOG_DEBUG("Tagging");
-  terrainFeature->Tag(tin);
-  waterFeature->Tag(tin);
-  pathFeature->Tag(tin);
-
-  // Write water and paths to KML
-  waterFeature->WriteWaterToKml();
-  pathFeature->WritePathsToKml();
-
   return fm;
 }
 
-FeatureManager SetupTimeRestrictSwimmingPreset(Tin &tin,
-                                               const MeshBoundary &boundary) {
-
-  // Feature Manager Configuration
-  TSR_LOG_TRACE("Setting up feature manager");
-  FeatureManager fm;
-
-  TSR_LOG_DEBUG("Constructors");
-
-  auto gradientFeature = std::make_shared<GradientFeature>("gradient");
-  auto distance = std::make_shared<DistanceFeature>("distance");
-  auto gradientSpeedInfluence =
-      std::make_shared<GradientSpeedFeature>("gradient_speed");
-  gradientSpeedInfluence->AddDependency(gradientFeature);
-
-  auto terrainFeature =
-      std::make_shared<CEHTerrainFeature>("terrain_type", 0.1);
-
-  auto waterFeature = std::make_shared<BoolWaterFeature>("water", 0.1);
-
-  auto pathFeature = std::make_shared<PathFeature>("paths", 0.05);
-
+/**
+ * @brief Speed influence of water, where water is traversable at the given
+ * swimming speed multiplier.
+ *
+ */
+static std::shared_ptr<FeatureBase>
+SetupSwimmingSpeed(const PresetFeatures &features, double swim_speed) {
   auto swimSpeed =
-      std::make_shared<ConstantFeature<double>>("swimSpeed", 0.001);
-  auto noImpact = std::make_shared<ConstantFeature<double>>("swimSpeed", 1);
+      std::make_shared<ConstantFeature<double>>("swimSpeed", swim_speed);
+  auto noImpact = std::make_shared<ConstantFeature<double>>("noImpact", 1);
   auto waterSpeedInfluence =
       std::make_shared<ConditionalFeature<double>>("water_speed");
   // If water
-  waterSpeedInfluence->AddDependency(waterFeature);
+  waterSpeedInfluence->AddDependency(features.water);
   // Then swimspeed
   waterSpeedInfluence->AddDependency(swimSpeed);
   // Else, don't impact speed
   waterSpeedInfluence->AddDependency(noImpact);
 
-  auto speedFeature = std::make_shared<MultiplierFeature>("speed");
-  speedFeature->AddDependency(waterSpeedInfluence, MultiplierFeature::DOUBLE);
-  speedFeature->AddDependency(terrainFeature, MultiplierFeature::DOUBLE);
-  speedFeature->AddDependency(gradientSpeedInfluence,
-                              MultiplierFeature::DOUBLE);
-
-  auto pathSpeed = std::make_shared<MultiplierFeature>("path_speed");
-  pathSpeed->AddDependency(gradientSpeedInfluence, MultiplierFeature::DOUBLE);
-
-  auto speedWithPathFeature =
-      std::make_shared<ConditionalFeature<double>>("speed_with_path");
-  speedWithPathFeature->AddDependency(pathFeature);
-  speedWithPathFeature->AddDependency(pathSpeed);
-  speedWithPathFeature->AddDependency(speedFeature);
+  return waterSpeedInfluence;
+}
 
-  auto inverseSpeedFeature =
-      std::make_shared<InverseFeature<double, double>>("inverse_speed");
-  inverseSpeedFeature->AddDependency(speedWithPathFeature);
+FeatureManager SetupTimePreset(const PresetFeatures &features) {
 
-  auto timeFeature = std::make_shared<MultiplierFeature>("time");
-  timeFeature->AddDependency(distance, MultiplierFeature::DOUBLE);
-  timeFeature->AddDependency(inverseSpeedFeature, MultiplierFeature::DOUBLE);
+  // Water is untraversable
+  auto waterSpeedInfluence =
+      std::make_shared<InverseFeature<bool, bool>>("water_speed");
+  waterSpeedInfluence->AddDependency(features.water);
 
-  fm.SetOutputFeature(timeFeature);
+  return SetupTimeGraph(features, waterSpeedInfluence,
+                        MultiplierFeature::BOOL);
+}
 
-  TSR_LOG_TRACE("initializing features");
+FeatureManager SetupTimeWithSwimmingPreset(const PresetFeatures &features) {
+  return SetupTimeGraph(features, SetupSwimmingSpeed(features, 0.89),
+                        MultiplierFeature::DOUBLE);
+}
 
-  TSR_LOG_DEBUG("Terrain");
-  terrainFeature->Initialize(tin, boundary);
-  TSR_LOG_DEBUG("Water");
-  waterFeature->Initialize(tin, boundary);
-  TSR_LOG_DEBUG("Paths");
-  pathFeature->Initialize(tin, boundary);
+FeatureManager
+SetupTimeRestrictSwimmingPreset(const PresetFeatures &features) {
+  return SetupTimeGraph(features, SetupSwimmingSpeed(features, 0.001),
+                        MultiplierFeature::DOUBLE);
+}
 
-  TSR_LOG_DEBUG("Tagging");
-  terrainFeature->Tag(tin);
-  waterFeature->Tag(tin);
-  pathFeature->Tag(tin);
+FeatureManager SetupTimePreset(Tin &tin, const MeshBoundary &boundary) {
+  return SetupTimePreset(SetupPresetFeatures(tin, boundary));
+}
 
-  // Write water and paths to KML
-  waterFeature->WriteWaterToKml();
-  pathFeature->WritePathsToKml();
+FeatureManager SetupTimeWithSwimmingPreset(Tin &tin,
+                                           const MeshBoundary &boundary) {
+  return SetupTimeWithSwimmingPreset(SetupPresetFeatures(tin, boundary));
+}
 
-  return fm;
+FeatureManager SetupTimeRestrictSwimmingPreset(Tin &tin,
+                                               const MeshBoundary &boundary) {
+  return SetupTimeRestrictSwimmingPreset(SetupPresetFeatures(tin, boundary));
 }
 
 FeatureManager SetupSimpleDistancePreset() {
@@ -0,0 +1,64 @@
+#include "tsr/RasterTile.hpp"
+#include "tsr/Logging.hpp"
+#include "tsr/Point3.hpp"
+
+#include <cpl_error.h>
+#include <gdal/gdal.h>
+
+#include <cstddef>
+#include <stdexcept>
+
+namespace tsr {
+
+RasterTile::RasterTile(GDALDatasetH dataset, GDALDataType data_type)
+    : data_type(data_type) {
+
+  if (dataset == nullptr) {
+    TSR_LOG_ERROR("raster tile dataset empty");
+    throw std::runtime_error("raster tile dataset empty");
+  }
+
+  if (GDALGetGeoTransform(dataset, this->geotransform.data()) != CE_None) {
+    TSR_LOG_ERROR("failed to get raster tile GeoTransform");
+    throw std::runtime_error("failed to get raster tile GeoTransform");
+  }
+
+  this->width = GDALGetRasterXSize(dataset);
+  this->height = GDALGetRasterYSize(dataset);
+  this->band_count = GDALGetRasterCount(dataset);
+  this->value_size = GDALGetDataTypeSizeBytes(data_type);
+
+  if (this->band_count < 1 || this->value_size == 0) {
+    TSR_LOG_ERROR("invalid raster tile");
+    throw std::runtime_error("invalid raster tile");
+  }
+
+  this->data.resize(static_cast<std::size_t>(this->width) * this->height *
+                    this->band_count * this->value_size);
+
+  // Read every band in a single call, stored band after band
+  if (GDALDatasetRasterIO(dataset, GF_Read, 0, 0, this->width, this->height,
+                          this->data.data(), this->width, this->height,
+                          data_type, this->band_count, nullptr, 0, 0,
+                          0) != CE_None) {
+    TSR_LOG_ERROR("failed to read raster tile");
+    throw std::runtime_error("failed to read raster tile");
+  }
+}
+
+bool RasterTile::GetPixel(const Point3 &point, int &x, int &y) const {
+  const double pixel_x = (point.x() - geotransform[0]) / geotransform[1];
+  const double pixel_y = (point.y() - geotransform[3]) / geotransform[5];
+
+  // Negated comparisons also reject NaN
+  if (!(pixel_x >= 0 && pixel_x < this->width && pixel_y >= 0 &&
+        pixel_y < this->height)) {
+    return false;
+  }
+
+  x = static_cast<int>(pixel_x);
+  y = static_cast<int>(pixel_y);
+  return true;
+}
+
+} // namespace tsr
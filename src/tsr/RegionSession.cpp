@@ -0,0 +1,146 @@
+#include "tsr/RegionSession.hpp"
+#include "tsr/ChunkInfo.hpp"
+#include "tsr/Logging.hpp"
+#include "tsr/PointProcessor.hpp"
+#include "tsr/Presets.hpp"
+#include "tsr/TinBuilder.hpp"
+
+#include <string>
+#include <tbb/parallel_invoke.h>
+#include <utility>
+#include <vector>
+
+namespace tsr {
+
+RegionSession::RegionSession(const std::string &api_key,
+                             const ChunkPipelineOptions &pipeline_options)
+    : RegionSession(
+          [api_key, pipeline_options](const MeshBoundary &boundary,
+                                      const ChunkFilter &chunk_filter) {
+            return InitializeTinFromBoundary(
+                boundary, api_key, DEFAULT_DEM_URL_FORMAT, TinBuilderOptions(),
+                pipeline_options, chunk_filter);
+          },
+          PreparePresetFeatureData) {}
+
+RegionSession::RegionSession(TinSource tin_source,
+                             FeatureDataSource feature_data_source)
+    : tin_source(std::move(tin_source)),
+      feature_data_source(std::move(feature_data_source)) {}
+
+bool RegionSession::IsLoaded(const Point3 &point) const {
+  for (const MeshBoundary &region : this->regions) {
+    if (region.IsBounded(point)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool RegionSession::IsLoaded(const ChunkInfo &chunk) const {
+  const Point3 corners[4] = {
+      TranslateWgs84PointToUtm(Point3(chunk.minLat, chunk.minLng, 0)),
+      TranslateWgs84PointToUtm(Point3(chunk.minLat, chunk.maxLng, 0)),
+      TranslateWgs84PointToUtm(Point3(chunk.maxLat, chunk.maxLng, 0)),
+      TranslateWgs84PointToUtm(Point3(chunk.maxLat, chunk.minLng, 0))};
+
+  // Regions are convex, so contain the chunk if they contain its corners. A
+  // chunk split between regions is rebuilt, as the TIN was clipped to each.
+  for (const MeshBoundary &region : this->regions) {
+    bool containsChunk = true;
+    for (const Point3 &corner : corners) {
+      containsChunk = containsChunk && region.IsBounded(corner);
+    }
+
+    if (containsChunk) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool RegionSession::Contains(const MeshBoundary &boundary) const {
+  // Checking each region alone may miss boundaries only covered by their
+  // union, which are then grown without inserting any duplicate points
+  for (const MeshBoundary &region : this->regions) {
+    if (region.ContainsSafe(boundary)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool RegionSession::Prepare(const MeshBoundary &boundary) {
+  if (Contains(boundary)) {
+    TSR_LOG_DEBUG("Reusing loaded TIN");
+    return false;
+  }
+
+  if (this->regions.empty()) {
+    TSR_LOG_DEBUG("Loading TIN");
+    Load(boundary);
+  } else {
+    TSR_LOG_DEBUG("Growing loaded TIN");
+    Grow(boundary);
+  }
+
+  this->regions.push_back(boundary);
+  return true;
+}
+
+void RegionSession::Load(const MeshBoundary &boundary) {
+  this->features = CreatePresetFeatures();
+
+  // The DEM and feature data are independent until constraints are inserted
+  tbb::parallel_invoke(
+      [&] {
+        Tin initialTin = this->tin_source(boundary, ChunkFilter());
+        this->tin.swap(initialTin);
+      },
+      [&] { this->feature_data_source(this->features, boundary); });
+
+  ApplyPresetFeatures(this->tin, this->features);
+}
+
+void RegionSession::Grow(const MeshBoundary &boundary) {
+
+  // Feature data in the loaded regions is already constrained in the TIN
+  this->features.terrain->ExcludeRegions(this->regions);
+  this->features.water->ExcludeRegions(this->regions);
+  this->features.paths->ExcludeRegions(this->regions);
+
+  // The DEM of the new region and its feature data are independent until
+  // the constraints are inserted. Only chunks the loaded regions don't cover
+  // are built.
+  Tin regionTin;
+  tbb::parallel_invoke(
+      [&] {
+        Tin initialTin =
+            this->tin_source(boundary, [this](const ChunkInfo &chunk) {
+              return !IsLoaded(chunk);
+            });
+        regionTin.swap(initialTin);
+      },
+      [&] { this->feature_data_source(this->features, boundary); });
+
+  // Only merge the points the loaded regions don't already cover
+  std::vector<Point3> points;
+  for (Vertex_handle vertex : regionTin.finite_vertex_handles()) {
+    if (!IsLoaded(vertex->point())) {
+      points.push_back(vertex->point());
+    }
+  }
+
+  TSR_LOG_TRACE("merging {} of {} vertices", points.size(),
+                regionTin.number_of_vertices());
+  InsertPoints(this->tin, points);
+
+  this->features.terrain->AddConstraints(this->tin);
+  this->features.water->AddConstraints(this->tin);
+  this->features.paths->AddConstraints(this->tin);
+
+  // Faces outside the new points and constraints keep their tags
+  RetagPresetFeatures(this->tin, this->features);
+}
+
+} // namespace tsr
@@ -0,0 +1,101 @@
+#include "tsr/TileCache.hpp"
+#include "tsr/ChunkInfo.hpp"
+#include "tsr/IO/ChunkCache.hpp"
+#include "tsr/Logging.hpp"
+#include "tsr/RasterTile.hpp"
+
+#include <boost/functional/hash.hpp>
+#include <gdal/gdal.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace tsr {
+
+std::size_t TileCache::TileKeyHash::operator()(const TileKey &key) const {
+  std::size_t seed = boost::hash<ChunkInfo>()(key.chunk);
+  boost::hash_combine(seed, key.cache_id);
+  boost::hash_combine(seed, static_cast<int>(key.data_type));
+  return seed;
+}
+
+/**
+ * @brief Loads a cached raster tile into memory, releasing the dataset
+ * immediately after. Returns nullptr if the tile is not cached.
+ *
+ */
+static std::shared_ptr<const RasterTile> LoadTile(const std::string &cache_id,
+                                                  const ChunkInfo &chunk,
+                                                  GDALDataType data_type) {
+  if (!IO::IsChunkCached(cache_id, chunk)) {
+    TSR_LOG_WARN("{} tile not available in cache", cache_id);
+    return nullptr;
+  }
+
+  GDALDatasetH dataset = nullptr;
+  IO::GetChunkFromCache<GDALDatasetH>(cache_id, chunk, dataset);
+
+  std::shared_ptr<const RasterTile> tile;
+  try {
+    tile = std::make_shared<const RasterTile>(dataset, data_type);
+  } catch (...) {
+    GDALReleaseDataset(dataset);
+    throw;
+  }
+
+  GDALReleaseDataset(dataset);
+  return tile;
+}
+
+std::shared_ptr<const RasterTile> TileCache::Get(const std::string &cache_id,
+                                                 const ChunkInfo &chunk,
+                                                 GDALDataType data_type) {
+  TileKey key = {cache_id, chunk, data_type};
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->index.find(key);
+    if (it != this->index.end()) {
+      // Mark as most recently used
+      this->entries.splice(this->entries.begin(), this->entries, it->second);
+      return it->second->second;
+    }
+  }
+
+  // Load outside the lock, so threads needing other tiles are not blocked
+  auto tile = LoadTile(cache_id, chunk, data_type);
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  // Another thread may have loaded the same tile meanwhile
+  auto it = this->index.find(key);
+  if (it != this->index.end()) {
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    return it->second->second;
+  }
+
+  this->entries.emplace_front(key, tile);
+  this->index[key] = this->entries.begin();
+
+  while (this->entries.size() > this->capacity) {
+    this->index.erase(this->entries.back().first);
+    this->entries.pop_back();
+  }
+
+  return tile;
+}
+
+void TileCache::Clear() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->entries.clear();
+  this->index.clear();
+}
+
+std::size_t TileCache::Size() const {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->entries.size();
+}
+
+} // namespace tsr
@@ -0,0 +1,316 @@
+#include "tsr/TinBuilder.hpp"
+#include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/Logging.hpp"
+#include "tsr/Point2.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/RasterTile.hpp"
+#include "tsr/Tin.hpp"
+
+#include <CGAL/convex_hull_2.h>
+#include <gdal/gdal.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+namespace tsr {
+
+namespace {
+
+/// Matches the no data value rasters are warped with
+const float DEFAULT_NODATA_VALUE = -9999.0;
+
+/// The sample of a face furthest from it, relative to the maximum error at the
+/// sample, with the vertices identifying the face. Faces are destroyed by
+/// later insertions, so candidates are checked to still be faces before use.
+struct Candidate {
+  double error;
+  int col;
+  int row;
+  Vertex_handle v0;
+  Vertex_handle v1;
+  Vertex_handle v2;
+
+  bool operator<(const Candidate &other) const { return error < other.error; }
+};
+
+class GreedyTinBuilder {
+private:
+  const std::vector<float> &elevations;
+  const int width;
+  const int height;
+  const std::array<double, 6> &geotransform;
+  const float nodata_value;
+  const TinBuilderOptions &options;
+
+  Tin tin;
+  std::priority_queue<Candidate> candidates;
+
+  bool IsValid(int col, int row) const {
+    return elevations[static_cast<std::size_t>(row) * width + col] !=
+           nodata_value;
+  }
+
+  /// Position of a sample, matching IO::ExtractGdalDatasetPoints
+  Point3 SamplePoint(int col, int row) const {
+    return Point3(geotransform[0] + col * geotransform[1],
+                  geotransform[3] + row * geotransform[5],
+                  elevations[static_cast<std::size_t>(row) * width + col]);
+  }
+
+  double MaxError(const Point3 &sample) const;
+  void InsertHull();
+  void ScanFace(Face_handle face);
+
+public:
+  GreedyTinBuilder(const std::vector<float> &elevations, int width, int height,
+                   const std::array<double, 6> &geotransform,
+                   float nodata_value, const TinBuilderOptions &options)
+      : elevations(elevations), width(width), height(height),
+        geotransform(geotransform), nodata_value(nodata_value),
+        options(options) {}
+
+  Tin Build();
+};
+
+double GreedyTinBuilder::MaxError(const Point3 &sample) const {
+  if (!options.corridor) {
+    return options.max_error;
+  }
+
+  const double halfHeight = options.corridor->height / 2;
+  const double fullResolution = options.full_resolution_fraction * halfHeight;
+
+  const double distance =
+      options.corridor->DistanceFromAxis(Point2(sample.x(), sample.y()));
+  if (distance <= fullResolution || fullResolution >= halfHeight) {
+    return options.max_error;
+  }
+
+  const double t = std::min(
+      1.0, (distance - fullResolution) / (halfHeight - fullResolution));
+  const double edgeMaxError =
+      std::max(options.edge_max_error, options.max_error);
+
+  return options.max_error + t * (edgeMaxError - options.max_error);
+}
+
+void GreedyTinBuilder::InsertHull() {
+
+  // The hull of the valid samples is the hull of each row's outermost ones
+  std::vector<Point3> rowEnds;
+  for (int row = 0; row < height; row++) {
+    int first = 0;
+    while (first < width && !IsValid(first, row)) {
+      first++;
+    }
+    if (first == width) {
+      continue;
+    }
+
+    int last = width - 1;
+    while (!IsValid(last, row)) {
+      last--;
+    }
+
+    rowEnds.push_back(SamplePoint(first, row));
+    rowEnds.push_back(SamplePoint(last, row));
+  }
+
+  std::vector<Point3> hull;
+  CGAL::convex_hull_2(rowEnds.begin(), rowEnds.end(), std::back_inserter(hull),
+                      tin.geom_traits());
+
+  InsertPoints(tin, hull);
+}
+
+void GreedyTinBuilder::ScanFace(Face_handle face) {
+  if (tin.is_infinite(face)) {
+    return;
+  }
+
+  const Point3 &p0 = face->vertex(0)->point();
+  const Point3 &p1 = face->vertex(1)->point();
+  const Point3 &p2 = face->vertex(2)->point();
+
+  const double det = (p1.y() - p2.y()) * (p0.x() - p2.x()) +
+                     (p2.x() - p1.x()) * (p0.y() - p2.y());
+  if (det == 0) {
+    return;
+  }
+
+  // Samples covered by the face's bounding box
+  auto toCol = [&](double x) {
+    return (x - geotransform[0]) / geotransform[1];
+  };
+  auto toRow = [&](double y) {
+    return (y - geotransform[3]) / geotransform[5];
+  };
+
+  const auto [minCol, maxCol] = std::minmax({toCol(p0.x()), toCol(p1.x()),
+                                             toCol(p2.x())});
+  const auto [minRow, maxRow] = std::minmax({toRow(p0.y()), toRow(p1.y()),
+                                             toRow(p2.y())});
+
+  const int colBegin = std::max(0, static_cast<int>(std::ceil(minCol)));
+  const int colEnd = std::min(width - 1, static_cast<int>(std::floor(maxCol)));
+  const int rowBegin = std::max(0, static_cast<int>(std::ceil(minRow)));
+  const int rowEnd = std::min(height - 1, static_cast<int>(std::floor(maxRow)));
+
+  const double EPSILON = 1e-9;
+
+  Candidate worst{1.0, -1, -1, face->vertex(0), face->vertex(1),
+                  face->vertex(2)};
+
+  for (int row = rowBegin; row <= rowEnd; row++) {
+    for (int col = colBegin; col <= colEnd; col++) {
+      if (!IsValid(col, row)) {
+        continue;
+      }
+
+      const Point3 sample = SamplePoint(col, row);
+
+      // Barycentric coordinates of the sample in the face
+      const double l0 = ((p1.y() - p2.y()) * (sample.x() - p2.x()) +
+                         (p2.x() - p1.x()) * (sample.y() - p2.y())) /
+                        det;
+      const double l1 = ((p2.y() - p0.y()) * (sample.x() - p2.x()) +
+                         (p0.x() - p2.x()) * (sample.y() - p2.y())) /
+                        det;
+      const double l2 = 1 - l0 - l1;
+
+      if (l0 < -EPSILON || l1 < -EPSILON || l2 < -EPSILON) {
+        continue;
+      }
+
+      const double error =
+          std::abs(sample.z() - (l0 * p0.z() + l1 * p1.z() + l2 * p2.z()));
+
+      // The maximum error is never below max_error, so most samples are
+      // rejected before it is calculated
+      if (error <= options.max_error) {
+        continue;
+      }
+
+      const double relativeError = error / MaxError(sample);
+      if (relativeError > worst.error) {
+        worst.error = relativeError;
+        worst.col = col;
+        worst.row = row;
+      }
+    }
+  }
+
+  if (worst.col >= 0) {
+    candidates.push(worst);
+  }
+}
+
+Tin GreedyTinBuilder::Build() {
+
+  InsertHull();
+  if (tin.dimension() < 2) {
+    TSR_LOG_WARN("elevation grid has too few samples to triangulate");
+    return tin;
+  }
+
+  for (Face_handle face : tin.finite_face_handles()) {
+    ScanFace(face);
+  }
+
+  // Insert the furthest sample until all are within the maximum error
+  while (!candidates.empty()) {
+    if (options.max_vertices > 0 &&
+        tin.number_of_vertices() >= options.max_vertices) {
+      TSR_LOG_TRACE("TIN builder reached vertex budget, relative error {}",
+                    candidates.top().error);
+      break;
+    }
+
+    Candidate candidate = candidates.top();
+    candidates.pop();
+
+    Face_handle face;
+    if (!tin.is_face(candidate.v0, candidate.v1, candidate.v2, face)) {
+      continue;
+    }
+
+    Vertex_handle vertex =
+        tin.insert(SamplePoint(candidate.col, candidate.row), face);
+
+    // Delaunay insertion only creates faces around the new vertex
+    Tin::Face_circulator incident = tin.incident_faces(vertex);
+    Tin::Face_circulator done = incident;
+    do {
+      ScanFace(incident);
+    } while (++incident != done);
+  }
+
+  return std::move(tin);
+}
+
+} // namespace
+
+Tin CreateTinFromElevationGrid(const std::vector<float> &elevations, int width,
+                               int height,
+                               const std::array<double, 6> &geotransform,
+                               float nodata_value,
+                               const TinBuilderOptions &options) {
+
+  if (elevations.size() != static_cast<std::size_t>(width) * height) {
+    TSR_LOG_ERROR("elevation grid size does not match its dimensions");
+    throw std::runtime_error(
+        "elevation grid size does not match its dimensions");
+  }
+
+  if (geotransform[2] != 0 || geotransform[4] != 0) {
+    TSR_LOG_ERROR("rotated elevation grids are not supported");
+    throw std::runtime_error("rotated elevation grids are not supported");
+  }
+
+  // Samples are only skipped once within the maximum error, so a bound of
+  // zero or less would insert every sample
+  if (options.max_error <= 0) {
+    TSR_LOG_ERROR("TIN maximum error must be positive");
+    throw std::runtime_error("TIN maximum error must be positive");
+  }
+
+  GreedyTinBuilder builder(elevations, width, height, geotransform,
+                           nodata_value, options);
+  Tin tin = builder.Build();
+
+  TSR_LOG_TRACE("built TIN with {} of {} samples", tin.number_of_vertices(),
+                elevations.size());
+
+  return tin;
+}
+
+Tin CreateTinFromDataset(GDALDatasetH dataset,
+                         const TinBuilderOptions &options) {
+
+  RasterTile tile(dataset, GDT_Float32);
+
+  int hasNoData = 0;
+  double noData =
+      GDALGetRasterNoDataValue(GDALGetRasterBand(dataset, 1), &hasNoData);
+
+  std::vector<float> elevations(static_cast<std::size_t>(tile.GetWidth()) *
+                                tile.GetHeight());
+  for (int row = 0; row < tile.GetHeight(); row++) {
+    for (int col = 0; col < tile.GetWidth(); col++) {
+      elevations[static_cast<std::size_t>(row) * tile.GetWidth() + col] =
+          tile.Value<float>(0, col, row);
+    }
+  }
+
+  return CreateTinFromElevationGrid(
+      elevations, tile.GetWidth(), tile.GetHeight(), tile.GetGeoTransform(),
+      hasNoData ? static_cast<float>(noData) : DEFAULT_NODATA_VALUE, options);
+}
+
+} // namespace tsr
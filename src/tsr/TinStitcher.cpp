@@ -0,0 +1,353 @@
+#include "tsr/TinStitcher.hpp"
+#include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/Logging.hpp"
+#include "tsr/MeshBoundary.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/Tin.hpp"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace tsr {
+
+namespace {
+
+/// Distance by which a neighbouring chunk's vertices may overlap a chunk's
+/// hull, from rasters of neighbouring chunks sharing edge pixels
+const double SEAM_MARGIN = 100;
+
+typedef std::pair<double, double> XYKey;
+
+XYKey MakeKey(const Point3 &point) { return {point.x(), point.y()}; }
+
+/// Edge of a chunk's convex hull, as the line a * x + b * y + c = 0, scaled
+/// so the hull interior is positive and the distance is in metres
+struct HullEdge {
+  double a;
+  double b;
+  double c;
+
+  double Distance(double x, double y) const { return a * x + b * y + c; }
+};
+
+/// Faces of a chunk which are kept in the merged TIN, and the vertices
+/// bordering the seams
+struct ChunkSplit {
+  std::set<Face_handle> safe_faces;
+  std::vector<Point3> seam_points;
+  std::vector<Point3> interior_points;
+};
+
+std::vector<HullEdge> CalculateHullEdges(const Tin &tin) {
+
+  std::vector<Point3> hull;
+  Tin::Vertex_circulator vertex = tin.incident_vertices(tin.infinite_vertex());
+  Tin::Vertex_circulator done = vertex;
+  do {
+    hull.push_back(vertex->point());
+  } while (++vertex != done);
+
+  // The mean of the hull vertices is inside the hull
+  double meanX = 0;
+  double meanY = 0;
+  for (const Point3 &point : hull) {
+    meanX += point.x() / hull.size();
+    meanY += point.y() / hull.size();
+  }
+
+  std::vector<HullEdge> edges;
+  for (std::size_t i = 0; i < hull.size(); i++) {
+    const Point3 &p = hull[i];
+    const Point3 &q = hull[(i + 1) % hull.size()];
+
+    double a = q.y() - p.y();
+    double b = p.x() - q.x();
+    double length = std::sqrt(a * a + b * b);
+    if (length == 0) {
+      continue;
+    }
+
+    HullEdge edge{a / length, b / length,
+                  -(a * p.x() + b * p.y()) / length};
+    if (edge.Distance(meanX, meanY) < 0) {
+      edge = {-edge.a, -edge.b, -edge.c};
+    }
+    edges.push_back(edge);
+  }
+
+  return edges;
+}
+
+/// A face is kept if its vertices are bounded and its circumcircle is within
+/// the chunk's hull, away from any neighbouring chunk's vertices
+bool IsSafeFace(Face_handle face, const std::vector<HullEdge> &hull,
+                const MeshBoundary &boundary) {
+
+  for (int i = 0; i < 3; i++) {
+    if (!boundary.IsBounded(face->vertex(i)->point())) {
+      return false;
+    }
+  }
+
+  const auto &p0 = face->vertex(0)->point();
+  const auto &p1 = face->vertex(1)->point();
+  const auto &p2 = face->vertex(2)->point();
+
+  TIN_K::Point_2 center = CGAL::circumcenter(TIN_K::Point_2(p0.x(), p0.y()),
+                                             TIN_K::Point_2(p1.x(), p1.y()),
+                                             TIN_K::Point_2(p2.x(), p2.y()));
+  double radius = std::sqrt(CGAL::squared_distance(
+      center, TIN_K::Point_2(p0.x(), p0.y())));
+
+  for (const HullEdge &edge : hull) {
+    if (edge.Distance(center.x(), center.y()) < radius + SEAM_MARGIN) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+ChunkSplit SplitChunk(const Tin &tin, const MeshBoundary &boundary) {
+  ChunkSplit split;
+
+  if (tin.dimension() < 2) {
+    for (auto vertex : tin.finite_vertex_handles()) {
+      if (boundary.IsBounded(vertex->point())) {
+        split.seam_points.push_back(vertex->point());
+      }
+    }
+    return split;
+  }
+
+  const std::vector<HullEdge> hull = CalculateHullEdges(tin);
+
+  for (Face_handle face : tin.finite_face_handles()) {
+    if (IsSafeFace(face, hull, boundary)) {
+      split.safe_faces.insert(face);
+    }
+  }
+
+  // Vertices surrounded by kept faces are interior, the rest border a seam
+  for (auto vertex : tin.finite_vertex_handles()) {
+    if (!boundary.IsBounded(vertex->point())) {
+      continue;
+    }
+
+    bool interior = true;
+    Tin::Face_circulator face = tin.incident_faces(vertex);
+    Tin::Face_circulator done = face;
+    do {
+      if (split.safe_faces.count(face) == 0) {
+        interior = false;
+        break;
+      }
+    } while (++face != done);
+
+    if (interior) {
+      split.interior_points.push_back(vertex->point());
+    } else {
+      split.seam_points.push_back(vertex->point());
+    }
+  }
+
+  return split;
+}
+
+/// Whether the point lies in a kept face of any chunk
+bool IsInSafeFace(const TIN_K::Point_2 &point,
+                  const std::vector<std::shared_ptr<const Tin>> &chunks,
+                  const std::vector<ChunkSplit> &splits,
+                  std::vector<Face_handle> &hints) {
+
+  for (std::size_t i = 0; i < chunks.size(); i++) {
+    if (chunks[i]->dimension() < 2) {
+      continue;
+    }
+
+    Face_handle face =
+        chunks[i]->locate(Point3(point.x(), point.y(), 0), hints[i]);
+    if (face == nullptr || chunks[i]->is_infinite(face)) {
+      continue;
+    }
+    hints[i] = face;
+
+    if (splits[i].safe_faces.count(face) > 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Builds the TIN's data structure from a set of faces, given as
+ * counterclockwise vertex triples. Edges with a single face form the hull,
+ * and are closed with infinite faces. Returns false if the faces do not form
+ * a valid triangulation.
+ */
+bool AssembleTin(Tin &tin, const std::vector<Point3> &points,
+                 const std::vector<std::array<XYKey, 3>> &faces) {
+
+  tin.clear();
+  auto &tds = tin.tds();
+
+  std::map<XYKey, Vertex_handle> vertices;
+  for (const Point3 &point : points) {
+    Vertex_handle vertex = tds.create_vertex();
+    vertex->set_point(point);
+    vertices.emplace(MakeKey(point), vertex);
+  }
+
+  // Each directed edge, mapped to the face on its left and the index of the
+  // vertex opposite it
+  std::map<std::pair<Vertex_handle, Vertex_handle>, std::pair<Face_handle, int>>
+      edges;
+
+  auto addFace = [&](Vertex_handle v0, Vertex_handle v1, Vertex_handle v2) {
+    Face_handle face = tds.create_face(v0, v1, v2);
+    for (int i = 0; i < 3; i++) {
+      face->vertex(i)->set_face(face);
+
+      auto edge = std::make_pair(face->vertex(Tin::ccw(i)),
+                                 face->vertex(Tin::cw(i)));
+      if (!edges.emplace(edge, std::make_pair(face, i)).second) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  for (const auto &face : faces) {
+    auto v0 = vertices.find(face[0]);
+    auto v1 = vertices.find(face[1]);
+    auto v2 = vertices.find(face[2]);
+    if (v0 == vertices.end() || v1 == vertices.end() || v2 == vertices.end()) {
+      return false;
+    }
+
+    if (!addFace(v0->second, v1->second, v2->second)) {
+      return false;
+    }
+  }
+
+  // Close each hull edge with an infinite face
+  std::vector<std::pair<Vertex_handle, Vertex_handle>> hullEdges;
+  for (const auto &[edge, face] : edges) {
+    if (edges.count({edge.second, edge.first}) == 0) {
+      hullEdges.push_back(edge);
+    }
+  }
+
+  for (const auto &[source, target] : hullEdges) {
+    if (!addFace(target, source, tin.infinite_vertex())) {
+      return false;
+    }
+  }
+
+  // Link the faces across each edge
+  for (const auto &[edge, face] : edges) {
+    auto twin = edges.find({edge.second, edge.first});
+    if (twin == edges.end()) {
+      return false;
+    }
+    face.first->set_neighbor(face.second, twin->second.first);
+  }
+
+  tds.set_dimension(2);
+
+  for (const auto &[key, vertex] : vertices) {
+    if (vertex->face() == nullptr) {
+      return false;
+    }
+  }
+
+  return tin.is_valid();
+}
+
+} // namespace
+
+Tin StitchChunkTins(const std::vector<std::shared_ptr<const Tin>> &chunks,
+                    const MeshBoundary &boundary, TinStitchStats *stats) {
+
+  // Split each chunk into its kept faces and seam vertices
+  std::vector<ChunkSplit> splits(chunks.size());
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, chunks.size()),
+                    [&](const tbb::blocked_range<std::size_t> &range) {
+                      for (std::size_t i = range.begin(); i != range.end();
+                           i++) {
+                        splits[i] = SplitChunk(*chunks[i], boundary);
+                      }
+                    });
+
+  std::vector<Point3> seamPoints;
+  std::vector<Point3> points;
+  std::vector<std::array<XYKey, 3>> faces;
+  for (std::size_t i = 0; i < chunks.size(); i++) {
+    const ChunkSplit &split = splits[i];
+    seamPoints.insert(seamPoints.end(), split.seam_points.begin(),
+                      split.seam_points.end());
+    points.insert(points.end(), split.interior_points.begin(),
+                  split.interior_points.end());
+
+    for (Face_handle face : split.safe_faces) {
+      faces.push_back({MakeKey(face->vertex(0)->point()),
+                       MakeKey(face->vertex(1)->point()),
+                       MakeKey(face->vertex(2)->point())});
+    }
+  }
+
+  // Triangulate the seams from their bordering vertices. Faces covering the
+  // chunk interiors are replaced by the kept faces.
+  Tin seamTin;
+  InsertPoints(seamTin, seamPoints);
+  points.insert(points.end(), seamPoints.begin(), seamPoints.end());
+
+  std::vector<Face_handle> hints(chunks.size());
+  std::size_t seamFaces = 0;
+  for (Face_handle face : seamTin.finite_face_handles()) {
+    const auto &p0 = face->vertex(0)->point();
+    const auto &p1 = face->vertex(1)->point();
+    const auto &p2 = face->vertex(2)->point();
+
+    TIN_K::Point_2 centroid((p0.x() + p1.x() + p2.x()) / 3,
+                            (p0.y() + p1.y() + p2.y()) / 3);
+    if (IsInSafeFace(centroid, chunks, splits, hints)) {
+      continue;
+    }
+
+    faces.push_back({MakeKey(p0), MakeKey(p1), MakeKey(p2)});
+    seamFaces++;
+  }
+
+  TSR_LOG_TRACE("stitching {} kept faces and {} seam faces",
+                faces.size() - seamFaces, seamFaces);
+
+  TinStitchStats stitchStats;
+  stitchStats.kept_faces = faces.size() - seamFaces;
+  stitchStats.seam_faces = seamFaces;
+
+  Tin tin;
+  if (faces.empty() || !AssembleTin(tin, points, faces)) {
+    TSR_LOG_WARN("stitched TIN invalid, inserting chunk vertices instead");
+    tin.clear();
+    InsertPoints(tin, points);
+    stitchStats.fell_back = true;
+  }
+
+  if (stats != nullptr) {
+    *stats = stitchStats;
+  }
+  return tin;
+}
+
+} // namespace tsr
@@ -1,17 +1,21 @@
 
 #include "tsr/TsrState.hpp"
+#include "tsr/CompactTin.hpp"
 #include "tsr/Logging.hpp"
 #include "tsr/Point3.hpp"
+#include "tsr/Tin.hpp"
+
+#include <algorithm>
 
 namespace tsr {
 
-void TsrState::ProcessWarnings() {
+template <typename TinType> void BasicTsrState<TinType>::ProcessWarnings() {
 
   TSR_LOG_TRACE("processing warnings");
 
   std::unordered_map<Face_handle, size_t> processedWarnings;
 
-  RouteNode currentNode = this->routes.at(end_vertex);
+  BasicRouteNode<TinType> currentNode = this->routes.at(end_vertex);
   while (currentNode.vertex != start_vertex) {
     currentNode = this->routes.at(currentNode.parent);
 
@@ -55,17 +59,18 @@ void TsrState::ProcessWarnings() {
   this->warnings.swap(processedWarnings);
 }
 
-std::vector<Point3> TsrState::fetchRoute() const {
+template <typename TinType>
+std::vector<Point3> BasicTsrState<TinType>::fetchRoute() const {
 
   // Get the end node point
   std::vector<Point3> route;
-  RouteNode current_node = this->routes.at(this->end_vertex);
+  BasicRouteNode<TinType> current_node = this->routes.at(this->end_vertex);
   TSR_LOG_TRACE("cost: {}", current_node.gCost);
-  route.push_back(this->end_vertex->point());
+  route.push_back(VertexPoint(this->end_vertex));
 
   while (current_node.vertex != this->start_vertex) {
     current_node = this->routes.at(current_node.parent);
-    route.push_back(current_node.vertex->point());
+    route.push_back(VertexPoint(current_node.vertex));
     TSR_LOG_TRACE("cost: {}", current_node.gCost);
   }
 
@@ -73,7 +78,9 @@ std::vector<Point3> TsrState::fetchRoute() const {
   return route;
 }
 
-size_t TsrState::AddWarning(const std::string &warning, const short priority) {
+template <typename TinType>
+size_t BasicTsrState<TinType>::AddWarning(const std::string &warning,
+                                          const short priority) {
   if (!warning_index.contains(warning)) {
     size_t index = warning_messages.size();
     warning_messages.push_back(warning);
@@ -87,7 +94,8 @@ size_t TsrState::AddWarning(const std::string &warning, const short priority) {
   }
 }
 
-double TsrState::estimateTime() const {
+template <typename TinType>
+double BasicTsrState<TinType>::estimateTime() const {
   if (this->routes.contains(end_vertex)) {
     double endCost = this->routes.at(end_vertex).gCost;
 
@@ -105,4 +113,7 @@ double TsrState::estimateTime() const {
   }
 }
 
-} // namespace tsr
\ No newline at end of file
+template struct BasicTsrState<Tin>;
+template struct BasicTsrState<CompactTin>;
+
+} // namespace tsr
@@ -0,0 +1,145 @@
+#include "tsr/WindowedRouter.hpp"
+#include "tsr/Logging.hpp"
+#include "tsr/MeshBoundary.hpp"
+#include "tsr/PointProcessor.hpp"
+#include "tsr/Presets.hpp"
+#include "tsr/Router.hpp"
+#include "tsr/Tin.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace tsr {
+
+namespace {
+
+/// Distance of the point's projection along the axis from its start
+double AxisPosition(const Point3 &p, const Point3 &axis_start, double dx,
+                    double dy) {
+  return (p.x() - axis_start.x()) * dx + (p.y() - axis_start.y()) * dy;
+}
+
+} // namespace
+
+std::size_t SelectKeptRouteIndex(const std::vector<double> &positions,
+                                 double start_position, double keep_position,
+                                 bool last_window) {
+
+  std::size_t kept = positions.size() - 1;
+  if (last_window) {
+    return kept;
+  }
+
+  for (std::size_t i = 1; i < positions.size(); i++) {
+    if (positions[i] >= keep_position) {
+      kept = i;
+      break;
+    }
+  }
+
+  // A route which turns back before the overlap would make no progress, so
+  // the whole window route is kept
+  if (positions[kept] <= start_position) {
+    kept = positions.size() - 1;
+  }
+
+  return kept;
+}
+
+void AppendWindowRoute(std::vector<Point3> &route,
+                       const std::vector<Point3> &window_route,
+                       std::size_t kept) {
+  std::size_t first = route.empty() ? 0 : 1;
+  route.insert(route.end(), window_route.begin() + first,
+               window_route.begin() + kept + 1);
+}
+
+WindowedRouter::WindowedRouter(const std::string &api_key,
+                               const WindowedRouterOptions &options,
+                               const ChunkPipelineOptions &pipeline_options)
+    : api_key(api_key), options(options), pipeline_options(pipeline_options) {
+
+  if (options.overlap < 0 || options.window_length <= options.overlap) {
+    TSR_LOG_ERROR("window length {} must be greater than its overlap {}",
+                  options.window_length, options.overlap);
+    throw std::runtime_error("window length must be greater than its overlap");
+  }
+}
+
+std::vector<Point3> WindowedRouter::Route(const Point3 &start_point,
+                                          const Point3 &end_point,
+                                          double radii_multiplier,
+                                          const PresetFactory &preset) {
+
+  double length = CalculateXYDistance(start_point, end_point);
+  if (length == 0) {
+    return {start_point};
+  }
+
+  // Unit direction of the axis
+  double dx = (end_point.x() - start_point.x()) / length;
+  double dy = (end_point.y() - start_point.y()) / length;
+
+  std::vector<Point3> route;
+  Point3 current = start_point;
+
+  std::size_t window = 0;
+  while (true) {
+    double position = AxisPosition(current, start_point, dx, dy);
+    bool lastWindow = length - position <= options.window_length;
+
+    double targetPosition =
+        lastWindow ? length : position + options.window_length;
+    Point3 target =
+        lastWindow ? end_point
+                   : Point3(start_point.x() + dx * targetPosition,
+                            start_point.y() + dy * targetPosition, 0);
+
+    TSR_LOG_INFO("routing window {} from {:.0f}m to {:.0f}m of {:.0f}m",
+                 window, position, targetPosition, length);
+
+    std::vector<Point3> windowRoute;
+    {
+      // The window's TIN and features are released at the end of the scope
+      MeshBoundary boundary(current, target, radii_multiplier);
+      Tin tin;
+      PresetFeatures features =
+          SetupTinWithPresetFeatures(tin, boundary, api_key, pipeline_options);
+      FeatureManager fm = preset(features);
+
+      Router router;
+      windowRoute = router.Route(tin, fm, boundary, current, target);
+    }
+
+    if (windowRoute.size() < 2) {
+      TSR_LOG_ERROR("window {} has no route", window);
+      throw std::runtime_error("window has no route");
+    }
+
+    // Keep the route up to the overlap, where the next window continues
+    std::vector<double> positions;
+    positions.reserve(windowRoute.size());
+    for (const Point3 &point : windowRoute) {
+      positions.push_back(AxisPosition(point, start_point, dx, dy));
+    }
+
+    std::size_t kept = SelectKeptRouteIndex(
+        positions, position, targetPosition - options.overlap, lastWindow);
+
+    AppendWindowRoute(route, windowRoute, kept);
+    current = windowRoute[kept];
+    window++;
+
+    if (lastWindow) {
+      break;
+    }
+  }
+
+  TSR_LOG_TRACE("windowed route has {} points over {} windows", route.size(),
+                window);
+  return route;
+}
+
+} // namespace tsr
@@ -29,6 +29,14 @@ int main(int argc, char *argv[]) {
 
 // #include "test_api.hpp"
 #include "test_feature.hpp"
+#include "test_MeshBoundary.hpp"
+#include "test_CompactTin.hpp"
+#include "test_TinSnapshot.hpp"
+#include "test_RegionSession.hpp"
+#include "test_DelaunayTriangulation.hpp"
+#include "test_TinBuilder.hpp"
+#include "test_TinStitcher.hpp"
+#include "test_WindowedRouter.hpp"
 // #include "test_featureManager.hpp"
 // #include "test_router.hpp"
 // #include "test_triangulation.hpp"
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include "tsr/CompactTin.hpp"
+#include "tsr/CostModel.hpp"
+#include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/MeshBoundary.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/PresetFeatures.hpp"
+#include "tsr/Router.hpp"
+#include "tsr/Tin.hpp"
+
+#include "tsr/Features/GradientSpeedFeature.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace tsr;
+
+namespace {
+
+Tin CreateHillTin() {
+  std::vector<Point3> points;
+  for (int y = 0; y < 30; y++) {
+    for (int x = 0; x < 30; x++) {
+      double dx = x - 15;
+      double dy = y - 15;
+
+      // Whole metre elevations are exact as floats, so both TINs have the
+      // same costs
+      double z = std::round(30 * std::exp(-(dx * dx + dy * dy) / 40));
+      points.push_back(Point3(x * 10, y * 10, z));
+    }
+  }
+
+  return CreateTinFromPoints(points);
+}
+
+} // namespace
+
+TEST(TestCompactTin, testConversionKeepsTriangulation) {
+
+  Tin tin = CreateHillTin();
+  tin.insert_constraint(Point3(20, 20, 0), Point3(200, 250, 0));
+
+  // Mark some face data to be carried across
+  std::size_t tagID = 0;
+  for (Face_handle face : tin.finite_face_handles()) {
+    face->set_tag_id(tagID++);
+    face->set_path(0, tagID % 2 == 0);
+  }
+
+  CompactTin compactTin = ConvertTinToCompactTin(tin);
+
+  ASSERT_TRUE(compactTin.is_valid());
+  ASSERT_EQ(compactTin.number_of_vertices(), tin.number_of_vertices());
+  ASSERT_EQ(compactTin.number_of_faces(), tin.number_of_faces());
+
+  // Vertex IDs are dense
+  std::vector<bool> seen(compactTin.number_of_vertices(), false);
+  for (CompactVertex_handle vertex : compactTin.finite_vertex_handles()) {
+    ASSERT_LT(vertex->info().id, seen.size());
+    ASSERT_FALSE(seen[vertex->info().id]);
+    seen[vertex->info().id] = true;
+  }
+
+  std::size_t constrainedEdges = 0;
+  for (auto edge : tin.finite_edges()) {
+    constrainedEdges += tin.is_constrained(edge);
+  }
+  std::size_t compactConstrainedEdges = 0;
+  for (auto edge : compactTin.finite_edges()) {
+    compactConstrainedEdges += compactTin.is_constrained(edge);
+  }
+  ASSERT_GT(constrainedEdges, 0);
+  ASSERT_EQ(compactConstrainedEdges, constrainedEdges);
+
+  // Converting back gives the same faces, with their data
+  Tin roundTrip = ConvertCompactTinToTin(compactTin);
+  ASSERT_TRUE(roundTrip.is_valid());
+
+  std::map<std::pair<double, double>, Vertex_handle> vertices;
+  for (Vertex_handle vertex : roundTrip.finite_vertex_handles()) {
+    vertices[{vertex->point().x(), vertex->point().y()}] = vertex;
+  }
+  ASSERT_EQ(vertices.size(), tin.number_of_vertices());
+
+  auto roundTripVertex = [&](Vertex_handle vertex) {
+    return vertices.at({vertex->point().x(), vertex->point().y()});
+  };
+
+  for (Face_handle face : tin.finite_face_handles()) {
+    Face_handle other;
+    ASSERT_TRUE(roundTrip.is_face(roundTripVertex(face->vertex(0)),
+                                  roundTripVertex(face->vertex(1)),
+                                  roundTripVertex(face->vertex(2)), other));
+    ASSERT_EQ(other->tag_id(), face->tag_id());
+
+    for (int i = 0; i < 3; i++) {
+      ASSERT_EQ(roundTripVertex(face->vertex(i))->point(),
+                face->vertex(i)->point());
+    }
+  }
+}
+
+TEST(TestCompactTin, testRouteMatchesTin) {
+
+  Tin tin = CreateHillTin();
+  CompactTin compactTin = ConvertTinToCompactTin(tin);
+
+  PresetFeatures features;
+  features.gradient_speed =
+      std::make_shared<GradientSpeedFeature>("gradient_speed");
+
+  using WalkingModel =
+      Cost::Time<Cost::Distance,
+                 Cost::Inverse<Cost::GradientSpeed<Cost::Gradient>>>;
+  WalkingModel model(features);
+
+  Point3 start(40, 150, 0);
+  Point3 end(250, 150, 0);
+  MeshBoundary boundary(start, end, 4);
+
+  Router router;
+  auto route = router.Route(tin, model, boundary, start, end);
+
+  CompactRouter compactRouter;
+  auto compactRoute =
+      compactRouter.Route(compactTin, model, boundary, start, end);
+
+  ASSERT_GT(route.size(), 2);
+  ASSERT_EQ(compactRoute, route);
+}
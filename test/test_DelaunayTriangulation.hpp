@@ -0,0 +1,279 @@
+#include <gtest/gtest.h>
+
+#include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/Logging.hpp"
+#include "tsr/Point2.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/Tin.hpp"
+
+#include <vector>
+
+using namespace tsr;
+
+TEST(TestDelaunayTriangulation, testConstraintAddBatched) {
+
+  std::vector<Point3> points;
+  points.push_back(Point3(0, 0, 0));
+  points.push_back(Point3(0, 40, 0));
+  points.push_back(Point3(40, 40, 10));
+  points.push_back(Point3(40, 0, 10));
+
+  // The second contour repeats the first segment, and leaves the TIN
+  std::vector<std::vector<Point2>> contours;
+  contours.push_back({Point2(10, 10), Point2(30, 10), Point2(30, 30)});
+  contours.push_back({Point2(10, 10), Point2(30, 10), Point2(60, 10)});
+
+  auto dtm = CreateTinFromPoints(points);
+
+  auto constraints = AddContourConstraints(dtm, contours, 22);
+
+  ASSERT_EQ(constraints.size(), 2);
+  ASSERT_EQ(dtm.number_of_vertices(), 7);
+
+  // Z is interpolated from the surface
+  ASSERT_NEAR(constraints[0].first.z(), 2.5, 1e-9);
+}
+
+TEST(TestDelaunayTriangulation, testInsertPointsRemovesDuplicates) {
+
+  std::vector<Point3> points;
+  for (int y = 0; y < 20; y++) {
+    for (int x = 0; x < 20; x++) {
+      points.push_back(Point3(x, y, x + y));
+    }
+  }
+
+  // Repeat a row with different heights
+  for (int x = 0; x < 20; x++) {
+    points.push_back(Point3(x, 0, -1));
+  }
+
+  auto dtm = CreateTinFromPoints(points);
+
+  ASSERT_EQ(dtm.number_of_vertices(), 400);
+  ASSERT_TRUE(dtm.is_valid());
+
+  // The first of the duplicated points is kept
+  for (auto vertex : dtm.finite_vertex_handles()) {
+    ASSERT_EQ(vertex->point().z(), vertex->point().x() + vertex->point().y());
+  }
+}
+
+TEST(TestDelaunayTriangulation, test_simplify_tin_tin) {
+  // Create mesh
+  // Create point set
+  std::vector<Point3> points;
+  points.push_back(Point3(0, 0, 1));
+  points.push_back(Point3(5, 0, 3));
+  points.push_back(Point3(2.5, 5, 2));
+
+  TSR_LOG_TRACE("constructing dtm");
+
+  auto dtm = CreateTinFromPoints(points);
+
+  TSR_LOG_TRACE("simplifying dtm");
+
+  // Simplify
+  ASSERT_NO_THROW(SimplifyTin(dtm, dtm));
+
+  ASSERT_TRUE(dtm.is_valid());
+}
+
+TEST(TestDelaunayTriangulation, test_simplify_tin_mesh_flat_plane) {
+
+  /**
+   * @brief Creates a flat plane with an extra vertice along an edge which
+   * should be removed upon simplification
+   *
+   *      *
+   *     / \
+   *    *   \
+   *   /     \
+   *  *- - - -*
+   *
+   */
+
+  std::vector<Point3> points;
+  points.push_back(Point3(0, 0, 0));
+  points.push_back(Point3(1, 2, 0)); // Additional vertice
+  points.push_back(Point3(2, 4, 0));
+  points.push_back(Point3(4, 0, 0));
+
+  auto dtm = CreateTinFromPoints(points);
+
+  // Simplify
+  SimplifyTin(dtm, dtm);
+
+  ASSERT_EQ(dtm.number_of_vertices(), 3);
+}
+
+TEST(TestDelaunayTriangulation, test_simplify_tin_mesh_small_angles) {
+
+  /**
+   * @brief Creates a flat plane with an extra vertice along an edge which
+   * should be removed upon simplification
+   *
+   *      *
+   *     / \
+   *    *   \
+   *   /     \
+   *  *- - - -*
+   *
+   */
+
+  std::vector<Point3> points;
+  points.push_back(Point3(0, 0, 0));
+  points.push_back(Point3(0.9, 2, 0)); // Additional vertice
+  points.push_back(Point3(2, 4, 0));
+  points.push_back(Point3(4, 0, 0));
+
+  auto dtm = CreateTinFromPoints(points);
+
+  Tin dtm_simple;
+
+  // Simplify, ensuring distance is not the limiting factor
+  SimplifyTin(dtm, dtm_simple, DEFAULT_COSINE_MAX_ANGLE_REGIONS, 10000,
+              DEFAULT_COSINE_MAX_ANGLE_CORNERS, 10000);
+
+  ASSERT_EQ(dtm_simple.number_of_vertices(), 3);
+}
+
+TEST(TestDelaunayTriangulation, test_simplify_tin_mesh_small_distances) {
+
+  /**
+   * @brief Creates a flat plane with an extra vertice along an edge which
+   * should be removed upon simplification
+   *
+   *      *
+   *     / \
+   *   *    \
+   *  /      \
+   *  *- - - -*
+   *
+   */
+
+  std::vector<Point3> points;
+  points.push_back(Point3(0, 0, 0));
+  points.push_back(Point3(0.9, 2, 0)); // Additional vertice
+  points.push_back(Point3(2, 4, 0));
+  points.push_back(Point3(4, 0, 0));
+
+  auto dtm = CreateTinFromPoints(points);
+
+  // Simplify, ensuring angle is not the limiting factor
+  SimplifyTin(dtm, dtm, 0, DEFAULT_MAX_DISTANCE_REGIONS, 0,
+              DEFAULT_MAX_DISTANCE_CORNERS);
+
+  ASSERT_EQ(dtm.number_of_vertices(), 3);
+}
+
+TEST(TestDelaunayTriangulation, test_simplify_tin_mesh_keeps_sharp_edges) {
+
+  /**
+   * @brief Creates a flat polygon, with one very elevated edge along the edge
+   * of the triangle which should not be removed as the angle is too great
+   *
+   *   _--*
+   *  *_   \
+   *  | \_  \
+   *  |   \ _\
+   *  *- - - -*
+   *
+   */
+
+  std::vector<Point3> points;
+  points.push_back(Point3(0, 0, 0));
+  points.push_back(Point3(1, 2, 100)); // Additional vertice
+  points.push_back(Point3(2, 4, 0));
+  points.push_back(Point3(4, 0, 0));
+
+  auto dtm = CreateTinFromPoints(points);
+
+  // Simplify, ensuring distance is not the limiting factor
+  SimplifyTin(dtm, dtm, DEFAULT_COSINE_MAX_ANGLE_REGIONS, 10000,
+              DEFAULT_COSINE_MAX_ANGLE_CORNERS, 10000);
+
+  ASSERT_EQ(dtm.number_of_vertices(), 4);
+}
+
+TEST(TestDelaunayTriangulation, test_simplify_tin_mesh_keeps_spike) {
+
+  /**
+   * @brief Creates a flat square with a very elevated vertex in its middle.
+   * No vertex should be removed, as the angles between the faces of the
+   * spike, and between the faces at each corner, are too great.
+   *
+   *  *-------*
+   *  | \   / |
+   *  |   *   |
+   *  | /   \ |
+   *  *-------*
+   *
+   */
+
+  std::vector<Point3> points;
+  points.push_back(Point3(0, 0, 0));
+  points.push_back(Point3(4, 0, 0));
+  points.push_back(Point3(4, 4, 0));
+  points.push_back(Point3(0, 4, 0));
+  points.push_back(Point3(2, 2, 100)); // Spike
+
+  auto dtm = CreateTinFromPoints(points);
+
+  // Simplify, ensuring distance is not the limiting factor
+  SimplifyTin(dtm, dtm, DEFAULT_COSINE_MAX_ANGLE_REGIONS, 10000,
+              DEFAULT_COSINE_MAX_ANGLE_CORNERS, 10000);
+
+  ASSERT_EQ(dtm.number_of_vertices(), 5);
+}
+
+TEST(TestDelaunayTriangulation, test_simplify_tin_mesh_keeps_long_distances) {
+
+  /**
+   * @brief Creates a flat plane with an extra vertice along an edge which
+   * should be removed upon simplification
+   *
+   *    _*
+   *   /   \
+   *  *     \
+   *  |      \
+   *  *- - - -*
+   *
+   */
+
+  std::vector<Point3> points;
+  points.push_back(Point3(0, 0, 0));
+  points.push_back(Point3(0, 20000, 0)); // Additional vertice
+  points.push_back(Point3(20000, 40000, 0));
+  points.push_back(Point3(40000, 0, 0));
+
+  auto dtm = CreateTinFromPoints(points);
+
+  // Simplify, ensuring angle is not the limiting factor
+  SimplifyTin(dtm, dtm, 0, DEFAULT_MAX_DISTANCE_REGIONS, 0,
+              DEFAULT_MAX_DISTANCE_CORNERS);
+
+  ASSERT_EQ(dtm.number_of_vertices(), 4);
+}
+
+TEST(TestDelaunayTriangulation, test_simplify_tin_removes_near_duplicates) {
+
+  // Curved surface, so no vertex is within the thresholds
+  std::vector<Point3> points;
+  for (int y = 0; y < 5; y++) {
+    for (int x = 0; x < 5; x++) {
+      points.push_back(Point3(x * 10, y * 10, x * x + 2 * y * y));
+    }
+  }
+
+  // Near duplicate of a grid vertex, with a very different elevation
+  points.push_back(Point3(20.005, 20, 400));
+
+  auto dtm = CreateTinFromPoints(points);
+  ASSERT_EQ(dtm.number_of_vertices(), 26);
+
+  SimplifyTin(dtm, dtm, 1, 0, 1, 0);
+
+  ASSERT_EQ(dtm.number_of_vertices(), 25);
+  ASSERT_TRUE(dtm.is_valid());
+}
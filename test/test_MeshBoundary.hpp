@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include "tsr/MeshBoundary.hpp"
+#include "tsr/Point2.hpp"
+#include "tsr/Point3.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace tsr;
+
+TEST(TestMeshBoundary, testClipContourInside) {
+
+  // 150 x 100 boundary centred on (50, 0), aligned with the x axis
+  MeshBoundary boundary(Point3(0, 0, 0), Point3(100, 0, 0), 1);
+
+  std::vector<Point2> contour = {Point2(0, 0), Point2(10, 10), Point2(20, 0)};
+
+  auto pieces = boundary.ClipContour(contour);
+
+  ASSERT_EQ(pieces.size(), 1);
+  ASSERT_EQ(pieces[0], contour);
+}
+
+TEST(TestMeshBoundary, testClipContourOutside) {
+
+  MeshBoundary boundary(Point3(0, 0, 0), Point3(100, 0, 0), 1);
+
+  std::vector<Point2> contour = {Point2(0, 100), Point2(100, 100)};
+
+  ASSERT_TRUE(boundary.ClipContour(contour).empty());
+}
+
+TEST(TestMeshBoundary, testClipContourCrossing) {
+
+  MeshBoundary boundary(Point3(0, 0, 0), Point3(100, 0, 0), 1);
+
+  // Leaves through the top edge, then re-enters
+  std::vector<Point2> contour = {Point2(0, 0), Point2(0, 100),
+                                 Point2(20, 100), Point2(20, 0)};
+
+  auto pieces = boundary.ClipContour(contour);
+
+  ASSERT_EQ(pieces.size(), 2);
+  ASSERT_EQ(pieces[0].size(), 2);
+  ASSERT_NEAR(pieces[0][1].x(), 0, 1e-9);
+  ASSERT_NEAR(pieces[0][1].y(), 50, 1e-9);
+  ASSERT_NEAR(pieces[1][0].x(), 20, 1e-9);
+  ASSERT_NEAR(pieces[1][0].y(), 50, 1e-9);
+  ASSERT_EQ(pieces[1][1], Point2(20, 0));
+}
+
+TEST(TestMeshBoundary, testSubtractContourCrossing) {
+
+  MeshBoundary boundary(Point3(0, 0, 0), Point3(100, 0, 0), 1);
+
+  // Leaves through the top edge, then re-enters
+  std::vector<Point2> contour = {Point2(0, 0), Point2(0, 100),
+                                 Point2(20, 100), Point2(20, 0)};
+
+  auto inside = boundary.ClipContour(contour);
+  auto outside = boundary.SubtractContour(contour);
+
+  ASSERT_EQ(outside.size(), 1);
+  ASSERT_EQ(outside[0].size(), 4);
+  ASSERT_EQ(outside[0][1], Point2(0, 100));
+  ASSERT_EQ(outside[0][2], Point2(20, 100));
+
+  // The pieces meet exactly where the contour crosses the edge
+  ASSERT_EQ(outside[0].front(), inside[0].back());
+  ASSERT_EQ(outside[0].back(), inside[1].front());
+}
+
+TEST(TestMeshBoundary, testSubtractContourInside) {
+
+  MeshBoundary boundary(Point3(0, 0, 0), Point3(100, 0, 0), 1);
+
+  std::vector<Point2> contour = {Point2(0, 0), Point2(10, 10), Point2(20, 0)};
+
+  ASSERT_TRUE(boundary.SubtractContour(contour).empty());
+
+  std::vector<Point2> outsideContour = {Point2(0, 100), Point2(100, 100)};
+
+  auto pieces = boundary.SubtractContour(outsideContour);
+
+  ASSERT_EQ(pieces.size(), 1);
+  ASSERT_EQ(pieces[0], outsideContour);
+}
+
+TEST(TestMeshBoundary, testClipContourRotated) {
+
+  // Diagonal boundary, so the rotated rectangle clips the contour
+  MeshBoundary boundary(Point3(0, 0, 0), Point3(100, 100, 0), 1);
+
+  std::vector<Point2> contour = {Point2(-200, 0), Point2(200, 0)};
+
+  auto pieces = boundary.ClipContour(contour);
+
+  ASSERT_EQ(pieces.size(), 1);
+  ASSERT_EQ(pieces[0].size(), 2);
+  ASSERT_NEAR(pieces[0][0].x(), -50, 1e-9);
+  ASSERT_NEAR(pieces[0][0].y(), 0, 1e-9);
+  ASSERT_NEAR(pieces[0][1].x(), 100, 1e-9);
+  ASSERT_NEAR(pieces[0][1].y(), 0, 1e-9);
+}
+
+TEST(TestMeshBoundary, testDistanceFromAxis) {
+
+  MeshBoundary boundary(Point3(0, 0, 0), Point3(100, 100, 0), 1);
+
+  // Beside the axis, and beyond its ends
+  ASSERT_NEAR(boundary.DistanceFromAxis(Point2(50, 50)), 0, 1e-9);
+  ASSERT_NEAR(boundary.DistanceFromAxis(Point2(100, 0)), std::sqrt(5000),
+              1e-9);
+  ASSERT_NEAR(boundary.DistanceFromAxis(Point2(-30, -40)), 50, 1e-9);
+  ASSERT_NEAR(boundary.DistanceFromAxis(Point2(130, 140)), 50, 1e-9);
+}
+
+TEST(TestMeshBoundary, testContainsSafe) {
+
+  MeshBoundary boundary(Point3(0, 0, 0), Point3(1000, 0, 0), 1.5);
+
+  ASSERT_TRUE(boundary.ContainsSafe(boundary));
+  ASSERT_TRUE(boundary.ContainsSafe(
+      MeshBoundary(Point3(200, 0, 0), Point3(600, 100, 0), 1)));
+
+  // Beyond the end of the boundary
+  ASSERT_FALSE(boundary.ContainsSafe(
+      MeshBoundary(Point3(800, 0, 0), Point3(1600, 0, 0), 1)));
+
+  // A boundary never contains a larger one around the same axis
+  ASSERT_FALSE(boundary.ContainsSafe(
+      MeshBoundary(Point3(0, 0, 0), Point3(1000, 0, 0), 2)));
+}
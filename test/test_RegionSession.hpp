@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+
+#include "tsr/ChunkInfo.hpp"
+#include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/MeshBoundary.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/PointProcessor.hpp"
+#include "tsr/PresetFeatures.hpp"
+#include "tsr/RegionSession.hpp"
+#include "tsr/Tin.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace tsr;
+
+/// Builds TINs from a grid of points over the requested boundary rather than
+/// the DEM, recording the chunk filter of each request
+struct GridTinSource {
+  Point3 origin;
+  double spacing;
+  double offset;
+  std::vector<ChunkFilter> *filters;
+
+  Tin operator()(const MeshBoundary &boundary,
+                 const ChunkFilter &chunk_filter) const {
+    filters->push_back(chunk_filter);
+    return CreateTinFromPoints(GridPoints(boundary));
+  }
+
+  /// Points of the grid inside the boundary
+  std::vector<Point3> GridPoints(const MeshBoundary &boundary) const {
+    std::vector<Point3> points;
+    const double extent = std::max(boundary.width, boundary.height);
+    const int steps = static_cast<int>(std::ceil(extent / spacing));
+
+    for (int i = -steps; i <= steps; i++) {
+      for (int j = -steps; j <= steps; j++) {
+        Point3 point(boundary.midpoint.x() + i * spacing + offset,
+                     boundary.midpoint.y() + j * spacing + offset,
+                     origin.z() + i + j);
+        if (boundary.IsBounded(point)) {
+          points.push_back(point);
+        }
+      }
+    }
+    return points;
+  }
+};
+
+/// Leaves the features without any data, so nothing is fetched
+static void PrepareNoFeatureData(const PresetFeatures &,
+                                 const MeshBoundary &) {}
+
+/// A point in the Lake District in UTM coordinates, so chunks convert back
+/// to real latitudes and longitudes
+static Point3 TestOrigin() {
+  Point3 origin = TranslateWgs84PointToUtm(Point3(54.45, -3.1, 0));
+  return Point3(std::round(origin.x()), std::round(origin.y()), 100);
+}
+
+/// 3 km by 2 km boundary centred on the point
+static MeshBoundary BoundaryAround(const Point3 &centre) {
+  return MeshBoundary(Point3(centre.x() - 1000, centre.y(), 0),
+                      Point3(centre.x() + 1000, centre.y(), 0), 1);
+}
+
+TEST(TestRegionSession, testContains) {
+  std::vector<ChunkFilter> filters;
+  const Point3 origin = TestOrigin();
+  RegionSession session(GridTinSource{origin, 100, 0, &filters},
+                        PrepareNoFeatureData);
+
+  const MeshBoundary region = BoundaryAround(origin);
+  const MeshBoundary inside(Point3(origin.x() - 500, origin.y(), 0),
+                            Point3(origin.x() + 500, origin.y(), 0), 1);
+  const MeshBoundary beyond =
+      BoundaryAround(Point3(origin.x() + 2500, origin.y(), 0));
+
+  ASSERT_FALSE(session.Contains(region));
+  ASSERT_FALSE(session.Contains(inside));
+
+  session.Prepare(region);
+
+  ASSERT_TRUE(session.Contains(region));
+  ASSERT_TRUE(session.Contains(inside));
+  ASSERT_FALSE(session.Contains(beyond));
+}
+
+TEST(TestRegionSession, testIsLoadedChunk) {
+  std::vector<ChunkFilter> filters;
+  const Point3 origin = TestOrigin();
+  RegionSession session(GridTinSource{origin, 100, 0, &filters},
+                        PrepareNoFeatureData);
+
+  // Roughly 200 m across, around the origin
+  const ChunkInfo inside = {54.449, -3.1015, 54.451, -3.0985};
+
+  // Straddles the northern edge, 1 km from the origin
+  const ChunkInfo straddling = {54.449, -3.1015, 54.47, -3.0985};
+
+  const ChunkInfo far = {54.6, -3.1015, 54.602, -3.0985};
+
+  ASSERT_FALSE(session.IsLoaded(inside));
+
+  session.Prepare(BoundaryAround(origin));
+
+  ASSERT_TRUE(session.IsLoaded(inside));
+  ASSERT_FALSE(session.IsLoaded(straddling));
+  ASSERT_FALSE(session.IsLoaded(far));
+}
+
+TEST(TestRegionSession, testPrepareLoadsReusesAndGrows) {
+  std::vector<ChunkFilter> filters;
+  const Point3 origin = TestOrigin();
+  RegionSession session(GridTinSource{origin, 100, 0, &filters},
+                        PrepareNoFeatureData);
+
+  const MeshBoundary region = BoundaryAround(origin);
+
+  // First load builds every chunk
+  ASSERT_TRUE(session.Prepare(region));
+  ASSERT_EQ(filters.size(), 1);
+  ASSERT_FALSE(filters[0]);
+  ASSERT_GT(session.GetTin().number_of_vertices(), 0);
+  const size_t loadedVertices = session.GetTin().number_of_vertices();
+
+  // Contained boundaries reuse the TIN without building anything
+  ASSERT_FALSE(session.Prepare(
+      MeshBoundary(Point3(origin.x() - 500, origin.y(), 0),
+                   Point3(origin.x() + 500, origin.y(), 0), 1)));
+  ASSERT_EQ(filters.size(), 1);
+  ASSERT_EQ(session.GetTin().number_of_vertices(), loadedVertices);
+  ASSERT_EQ(session.GetRegions().size(), 1);
+
+  // Others grow it, skipping the chunks already loaded
+  ASSERT_TRUE(session.Prepare(
+      BoundaryAround(Point3(origin.x() + 2000, origin.y(), 0))));
+  ASSERT_EQ(filters.size(), 2);
+  ASSERT_TRUE(filters[1]);
+  ASSERT_FALSE(filters[1]({54.449, -3.1015, 54.451, -3.0985}));
+  ASSERT_TRUE(filters[1]({54.6, -3.1015, 54.602, -3.0985}));
+  ASSERT_GT(session.GetTin().number_of_vertices(), loadedVertices);
+  ASSERT_EQ(session.GetRegions().size(), 2);
+}
+
+TEST(TestRegionSession, testGrowOnlyInsertsPointsOutsideLoadedRegions) {
+  std::vector<ChunkFilter> filters;
+  const Point3 origin = TestOrigin();
+
+  // Offset the grid of the grown region, so any of its points inside the
+  // loaded region would be inserted as new vertices
+  GridTinSource loadSource{origin, 100, 0, &filters};
+  GridTinSource growSource{origin, 100, 50, &filters};
+  bool grown = false;
+
+  RegionSession session(
+      [&](const MeshBoundary &boundary, const ChunkFilter &chunk_filter) {
+        return grown ? growSource(boundary, chunk_filter)
+                     : loadSource(boundary, chunk_filter);
+      },
+      PrepareNoFeatureData);
+
+  const MeshBoundary region = BoundaryAround(origin);
+  const MeshBoundary grownRegion =
+      BoundaryAround(Point3(origin.x() + 1500, origin.y(), 0));
+
+  session.Prepare(region);
+  grown = true;
+  session.Prepare(grownRegion);
+
+  std::set<std::pair<double, double>> loadedPoints;
+  for (const Point3 &point : loadSource.GridPoints(region)) {
+    loadedPoints.insert({point.x(), point.y()});
+  }
+
+  size_t outsidePoints = 0;
+  for (const Point3 &point : growSource.GridPoints(grownRegion)) {
+    if (!region.IsBounded(point)) {
+      outsidePoints++;
+    }
+  }
+  ASSERT_GT(outsidePoints, 0);
+
+  // Vertices in the loaded region are exactly the points it was loaded with
+  size_t loadedVertices = 0;
+  for (Vertex_handle vertex : session.GetTin().finite_vertex_handles()) {
+    if (region.IsBounded(vertex->point())) {
+      loadedVertices++;
+      ASSERT_EQ(loadedPoints.count({vertex->point().x(), vertex->point().y()}),
+                1);
+    }
+  }
+
+  ASSERT_EQ(loadedVertices, loadedPoints.size());
+  ASSERT_EQ(session.GetTin().number_of_vertices(),
+            loadedPoints.size() + outsidePoints);
+}
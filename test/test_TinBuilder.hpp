@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/GeometryUtils.hpp"
+#include "tsr/MeshBoundary.hpp"
+#include "tsr/Point2.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/Tin.hpp"
+#include "tsr/TinBuilder.hpp"
+
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace tsr;
+
+TEST(TestTinBuilder, testGreedyTinBuilderErrorBound) {
+
+  const int SIZE = 50;
+  std::array<double, 6> geotransform = {0, 10, 0, 500, 0, -10};
+
+  // A plane with a single hill
+  std::vector<float> elevations(SIZE * SIZE);
+  for (int row = 0; row < SIZE; row++) {
+    for (int col = 0; col < SIZE; col++) {
+      double dx = col - 25;
+      double dy = row - 25;
+      elevations[row * SIZE + col] =
+          col * 0.5 + 40 * std::exp(-(dx * dx + dy * dy) / 50);
+    }
+  }
+
+  TinBuilderOptions options;
+  options.max_error = 0.5;
+
+  Tin tin = CreateTinFromElevationGrid(elevations, SIZE, SIZE, geotransform,
+                                       -9999, options);
+
+  ASSERT_TRUE(tin.is_valid());
+  ASSERT_LT(tin.number_of_vertices(), SIZE * SIZE / 4);
+
+  // Every interior sample is within the maximum error of the TIN
+  Face_handle hint;
+  for (int row = 1; row < SIZE - 1; row++) {
+    for (int col = 1; col < SIZE - 1; col++) {
+      double x = col * 10;
+      double y = 500 - row * 10;
+      hint = tin.locate(Point3(x, y, 0), hint);
+      ASSERT_FALSE(tin.is_infinite(hint));
+
+      double z = InterpolateZ(hint->vertex(0)->point(),
+                              hint->vertex(1)->point(),
+                              hint->vertex(2)->point(), x, y);
+      ASSERT_NEAR(z, elevations[row * SIZE + col], options.max_error + 1e-6);
+    }
+  }
+
+  // The vertex budget caps the TIN size
+  options.max_vertices = 20;
+  Tin budgetTin = CreateTinFromElevationGrid(elevations, SIZE, SIZE,
+                                             geotransform, -9999, options);
+  ASSERT_EQ(budgetTin.number_of_vertices(), 20);
+}
+
+TEST(TestTinBuilder, testNonPositiveMaxErrorThrows) {
+
+  std::array<double, 6> geotransform = {0, 10, 0, 20, 0, -10};
+  std::vector<float> elevations = {0, 1, 2, 3};
+
+  TinBuilderOptions options;
+  options.max_error = 0;
+  ASSERT_THROW(CreateTinFromElevationGrid(elevations, 2, 2, geotransform,
+                                          -9999, options),
+               std::runtime_error);
+
+  options.max_error = -1;
+  ASSERT_THROW(CreateTinFromElevationGrid(elevations, 2, 2, geotransform,
+                                          -9999, options),
+               std::runtime_error);
+}
+
+TEST(TestTinBuilder, testGreedyTinBuilderCorridor) {
+
+  const int SIZE = 60;
+  std::array<double, 6> geotransform = {0, 10, 0, 600, 0, -10};
+
+  // Rough terrain, so the error bound decides the vertex count
+  std::vector<float> elevations(SIZE * SIZE);
+  for (int row = 0; row < SIZE; row++) {
+    for (int col = 0; col < SIZE; col++) {
+      elevations[row * SIZE + col] =
+          20 * std::sin(col * 0.4) * std::cos(row * 0.3) + col * 0.5;
+    }
+  }
+
+  TinBuilderOptions options;
+  options.max_error = 0.5;
+  options.edge_max_error = 5;
+
+  Tin uniformTin = CreateTinFromElevationGrid(elevations, SIZE, SIZE,
+                                              geotransform, -9999, options);
+
+  // A corridor along the middle row of the grid
+  options.corridor = MeshBoundary(Point3(100, 300, 0), Point3(500, 300, 0), 1);
+  Tin corridorTin = CreateTinFromElevationGrid(elevations, SIZE, SIZE,
+                                               geotransform, -9999, options);
+
+  ASSERT_TRUE(corridorTin.is_valid());
+  ASSERT_LT(corridorTin.number_of_vertices(), uniformTin.number_of_vertices());
+
+  // Samples near the axis keep the full resolution error bound
+  Face_handle hint;
+  for (int row = 1; row < SIZE - 1; row++) {
+    for (int col = 1; col < SIZE - 1; col++) {
+      double x = col * 10;
+      double y = 600 - row * 10;
+      hint = corridorTin.locate(Point3(x, y, 0), hint);
+
+      double z = InterpolateZ(hint->vertex(0)->point(),
+                              hint->vertex(1)->point(),
+                              hint->vertex(2)->point(), x, y);
+
+      double distance = options.corridor->DistanceFromAxis(Point2(x, y));
+      double maxError = distance <= 50 ? options.max_error
+                                       : options.edge_max_error;
+      ASSERT_NEAR(z, elevations[row * SIZE + col], maxError + 1e-6);
+    }
+  }
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/FaceTagger.hpp"
+#include "tsr/Features/CEHTerrainFeature.hpp"
+#include "tsr/Features/RasterFeature.hpp"
+#include "tsr/IO/TinSnapshot.hpp"
+#include "tsr/MeshBoundary.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/Tin.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace tsr;
+
+TEST(TestTinSnapshot, testSnapshotRoundTrip) {
+
+  std::vector<Point3> points;
+  for (int y = 0; y < 20; y++) {
+    for (int x = 0; x < 20; x++) {
+      points.push_back(Point3(x * 10, y * 10, std::sin(x) * std::cos(y)));
+    }
+  }
+  Tin tin = CreateTinFromPoints(points);
+  tin.insert_constraint(Point3(15, 15, 0), Point3(150, 170, 0));
+
+  MeshBoundary boundary(Point3(20, 100, 0), Point3(180, 100, 0), 1.5);
+
+  std::uint32_t tagID = 0;
+  for (Face_handle face : tin.finite_face_handles()) {
+    face->set_tag_id(tagID++);
+    face->set_path(tagID % 3, true);
+  }
+
+  std::vector<std::uint8_t> tags(tagID);
+  for (std::size_t i = 0; i < tags.size(); i++) {
+    tags[i] = i % CEH_TERRAIN_TYPE::NO_DATA;
+  }
+  CEHTerrainFeature terrain("terrain_type", 0.1);
+  terrain.ImportTags(tags.data(), tags.size());
+
+  std::string filepath =
+      (std::filesystem::temp_directory_path() / "tsr_test_snapshot.bin")
+          .string();
+  std::vector<IO::PathSegment> segments = {
+      {Point3(15, 15, 0), Point3(150, 170, 0)}};
+  ASSERT_TRUE(
+      IO::WriteTinSnapshot(filepath, tin, boundary, {&terrain}, segments));
+
+  // Snapshots of other regions are not loaded
+  Tin otherTin;
+  CEHTerrainFeature otherTerrain("terrain_type", 0.1);
+  std::vector<IO::PathSegment> otherSegments;
+  MeshBoundary otherBoundary(Point3(20, 100, 0), Point3(180, 120, 0), 1.5);
+  ASSERT_FALSE(IO::LoadTinSnapshot(filepath, otherBoundary, otherTin,
+                                   {&otherTerrain}, otherSegments));
+
+  Tin loaded;
+  CEHTerrainFeature loadedTerrain("terrain_type", 0.1);
+  std::vector<IO::PathSegment> loadedSegments;
+  ASSERT_TRUE(IO::LoadTinSnapshot(filepath, boundary, loaded,
+                                  {&loadedTerrain}, loadedSegments));
+  std::filesystem::remove(filepath);
+
+  ASSERT_TRUE(loaded.is_valid());
+  ASSERT_EQ(loaded.number_of_vertices(), tin.number_of_vertices());
+  ASSERT_EQ(loaded.number_of_faces(), tin.number_of_faces());
+  ASSERT_EQ(loadedTerrain.ExportTags(), tags);
+  ASSERT_EQ(loadedSegments, segments);
+
+  // Loaded faces are signed with their new vertices, so are not retagged
+  FaceTagger tagger;
+  ASSERT_TRUE(tagger.Retag(loaded).empty());
+
+  std::map<std::pair<double, double>, Vertex_handle> vertices;
+  for (Vertex_handle vertex : loaded.finite_vertex_handles()) {
+    vertices[{vertex->point().x(), vertex->point().y()}] = vertex;
+  }
+
+  auto loadedVertex = [&](Vertex_handle vertex) {
+    return vertices.at({vertex->point().x(), vertex->point().y()});
+  };
+
+  // Each face is loaded with its data, in the same vertex order
+  for (Face_handle face : tin.finite_face_handles()) {
+    Face_handle other;
+    ASSERT_TRUE(loaded.is_face(loadedVertex(face->vertex(0)),
+                               loadedVertex(face->vertex(1)),
+                               loadedVertex(face->vertex(2)), other));
+    ASSERT_EQ(other->tag_id(), face->tag_id());
+    ASSERT_EQ(other->tag_signature(), CalculateFaceSignature(other));
+
+    for (int i = 0; i < 3; i++) {
+      int j = other->index(loadedVertex(face->vertex(i)));
+      ASSERT_EQ(other->vertex(j)->point(), face->vertex(i)->point());
+      ASSERT_EQ(other->is_constrained(j), face->is_constrained(i));
+      ASSERT_EQ(other->is_path(j), face->is_path(i));
+    }
+  }
+}
+
+TEST(TestTinSnapshot, testSnapshotRejectsMismatchedTags) {
+
+  std::vector<Point3> points = {Point3(0, 0, 0), Point3(10, 0, 0),
+                                Point3(0, 10, 0), Point3(10, 10, 0)};
+  Tin tin = CreateTinFromPoints(points);
+  MeshBoundary boundary(Point3(0, 5, 0), Point3(10, 5, 0), 1.5);
+
+  std::vector<std::uint8_t> tags(2, CEH_TERRAIN_TYPE::URBAN);
+  CEHTerrainFeature terrain("terrain_type", 0.1);
+  terrain.ImportTags(tags.data(), tags.size());
+  CEHTerrainFeature otherTerrain("terrain_type", 0.1);
+  otherTerrain.ImportTags(tags.data(), 1);
+
+  std::string filepath =
+      (std::filesystem::temp_directory_path() / "tsr_test_mismatched.bin")
+          .string();
+  ASSERT_FALSE(IO::WriteTinSnapshot(filepath, tin, boundary,
+                                    {&terrain, &otherTerrain}, {}));
+  ASSERT_FALSE(std::filesystem::exists(filepath));
+  ASSERT_FALSE(std::filesystem::exists(filepath + ".tmp"));
+}
+
+TEST(TestTinSnapshot, testTruncatedSnapshotThrows) {
+
+  std::vector<Point3> points = {Point3(0, 0, 0), Point3(10, 0, 0),
+                                Point3(0, 10, 0), Point3(10, 10, 0)};
+  Tin tin = CreateTinFromPoints(points);
+  MeshBoundary boundary(Point3(0, 5, 0), Point3(10, 5, 0), 1.5);
+  CEHTerrainFeature terrain("terrain_type", 0.1);
+
+  std::string filepath =
+      (std::filesystem::temp_directory_path() / "tsr_test_truncated.bin")
+          .string();
+  ASSERT_TRUE(IO::WriteTinSnapshot(filepath, tin, boundary, {&terrain}, {}));
+  ASSERT_FALSE(std::filesystem::exists(filepath + ".tmp"));
+
+  // As left by a write interrupted before the snapshot was complete
+  std::filesystem::resize_file(filepath,
+                               std::filesystem::file_size(filepath) - 1);
+
+  Tin loaded;
+  CEHTerrainFeature loadedTerrain("terrain_type", 0.1);
+  std::vector<IO::PathSegment> loadedSegments;
+  ASSERT_THROW(IO::LoadTinSnapshot(filepath, boundary, loaded,
+                                   {&loadedTerrain}, loadedSegments),
+               std::runtime_error);
+  std::filesystem::remove(filepath);
+
+  // The TIN is left as it was
+  ASSERT_EQ(loaded.number_of_vertices(), 0);
+}
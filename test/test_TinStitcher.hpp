@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/MeshBoundary.hpp"
+#include "tsr/Point3.hpp"
+#include "tsr/Tin.hpp"
+#include "tsr/TinStitcher.hpp"
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace tsr;
+
+TEST(TestTinStitcher, testStitchChunkTins) {
+
+  // Scattered points over two chunks, overlapping like neighbouring rasters
+  std::vector<Point3> left;
+  std::vector<Point3> right;
+  unsigned int seed = 1;
+  for (int i = 0; i < 4000; i++) {
+    seed = seed * 1103515245 + 12345;
+    double x = (seed >> 8) % 200000 / 100.0;
+    seed = seed * 1103515245 + 12345;
+    double y = (seed >> 8) % 100000 / 100.0;
+
+    if (x <= 1050) {
+      left.push_back(Point3(x, y, x + y));
+    }
+    if (x >= 950) {
+      right.push_back(Point3(x, y, x + y));
+    }
+  }
+
+  std::vector<Point3> all = left;
+  all.insert(all.end(), right.begin(), right.end());
+  Tin expected = CreateTinFromPoints(all);
+
+  MeshBoundary boundary(Point3(0, 500, 0), Point3(2000, 500, 0), 3);
+  std::vector<std::shared_ptr<const Tin>> chunks = {
+      std::make_shared<Tin>(CreateTinFromPoints(left)),
+      std::make_shared<Tin>(CreateTinFromPoints(right))};
+
+  TinStitchStats stats;
+  Tin tin = StitchChunkTins(chunks, boundary, &stats);
+
+  // The chunk faces were kept, rather than inserting every vertex
+  ASSERT_FALSE(stats.fell_back);
+  ASSERT_GT(stats.kept_faces, 0);
+  ASSERT_GT(stats.seam_faces, 0);
+
+  ASSERT_TRUE(tin.is_valid());
+  ASSERT_EQ(tin.number_of_vertices(), expected.number_of_vertices());
+  ASSERT_EQ(tin.number_of_faces(), expected.number_of_faces());
+
+  std::map<std::pair<double, double>, Vertex_handle> vertices;
+  for (Vertex_handle vertex : tin.finite_vertex_handles()) {
+    vertices[{vertex->point().x(), vertex->point().y()}] = vertex;
+  }
+
+  auto stitchedVertex = [&](Vertex_handle vertex) {
+    return vertices.at({vertex->point().x(), vertex->point().y()});
+  };
+
+  // The Delaunay triangulation is unique, so every face of the TIN of all
+  // the points is a face of the stitched TIN
+  for (Face_handle face : expected.finite_face_handles()) {
+    Face_handle stitched;
+    ASSERT_TRUE(tin.is_face(stitchedVertex(face->vertex(0)),
+                            stitchedVertex(face->vertex(1)),
+                            stitchedVertex(face->vertex(2)), stitched));
+  }
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include "tsr/Point3.hpp"
+#include "tsr/WindowedRouter.hpp"
+
+#include <cstddef>
+#include <vector>
+
+using namespace tsr;
+
+TEST(TestWindowedRouter, testKeepsRouteUpToOverlap) {
+
+  // Window from 0m to 10000m, with the overlap starting at 8000m
+  std::vector<double> positions = {0, 3000, 6000, 9000, 10000};
+  ASSERT_EQ(SelectKeptRouteIndex(positions, 0, 8000, false), 3);
+}
+
+TEST(TestWindowedRouter, testKeepsFirstVertexInOverlap) {
+
+  // The route enters the overlap, turns back out of it, then reaches it again
+  std::vector<double> positions = {0, 5000, 8500, 7000, 9500, 10000};
+  ASSERT_EQ(SelectKeptRouteIndex(positions, 0, 8000, false), 2);
+
+  // Turning back before the overlap doesn't cut the route early
+  positions = {0, 4000, 2000, 8200, 10000};
+  ASSERT_EQ(SelectKeptRouteIndex(positions, 0, 8000, false), 3);
+}
+
+TEST(TestWindowedRouter, testKeepsWholeRouteWithoutProgress) {
+
+  // The route never reaches the overlap
+  std::vector<double> positions = {0, 2000, 1000, 7000};
+  ASSERT_EQ(SelectKeptRouteIndex(positions, 0, 8000, false), 3);
+
+  // Only the start reaches the overlap, which would make no progress
+  positions = {8000, 7000, 6000};
+  ASSERT_EQ(SelectKeptRouteIndex(positions, 8000, 8000, false), 2);
+}
+
+TEST(TestWindowedRouter, testKeepsWholeRouteInLastWindow) {
+
+  std::vector<double> positions = {0, 3000, 6000, 9000, 10000};
+  ASSERT_EQ(SelectKeptRouteIndex(positions, 0, 8000, true), 4);
+}
+
+TEST(TestWindowedRouter, testAppendWindowRouteJoinsOnce) {
+
+  std::vector<Point3> route;
+  std::vector<Point3> first = {Point3(0, 0, 0), Point3(1, 0, 0),
+                               Point3(2, 0, 0), Point3(3, 0, 0)};
+  AppendWindowRoute(route, first, 2);
+  ASSERT_EQ(route, std::vector<Point3>(first.begin(), first.begin() + 3));
+
+  // The next window starts at the last kept vertex
+  std::vector<Point3> second = {Point3(2, 0, 0), Point3(2, 1, 0),
+                                Point3(3, 1, 0)};
+  AppendWindowRoute(route, second, 2);
+
+  std::vector<Point3> expected = {Point3(0, 0, 0), Point3(1, 0, 0),
+                                  Point3(2, 0, 0), Point3(2, 1, 0),
+                                  Point3(3, 1, 0)};
+  ASSERT_EQ(route, expected);
+}
@@ -1,14 +1,23 @@
+#include "tsr/ChunkManager.hpp"
+#include "tsr/CostModel.hpp"
 #include "tsr/DelaunayTriangulation.hpp"
+#include "tsr/FaceTagger.hpp"
+#include "tsr/FeatureProfile.hpp"
 #include "tsr/Features/BoolWaterFeature.hpp"
 #include "tsr/Features/CEHTerrainFeature.hpp"
+#include "tsr/Features/ConstantFeature.hpp"
+#include "tsr/Features/GradientSpeedFeature.hpp"
 #include "tsr/Features/PathFeature.hpp"
+#include "tsr/Features/RasterFeature.hpp"
 #include "tsr/Features/SimpleBooleanFeature.hpp"
 #include "tsr/Features/SimpleBooleanToDoubleFeature.hpp"
+#include "tsr/Features/TabulatedFeature.hpp"
 #include "tsr/GeometryUtils.hpp"
 #include "tsr/IO/MeshIO.hpp"
 #include "tsr/MeshBoundary.hpp"
 #include "tsr/Point3.hpp"
 #include "tsr/PointProcessor.hpp"
+#include "tsr/RasterTile.hpp"
 #include "tsr/Tin.hpp"
 #include <gdal/gdal.h>
 #include <gtest/gtest.h>
@@ -19,7 +28,14 @@
 #include "tsr/IO/MapIO.hpp"
 #include "tsr/TsrState.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <ratio>
+#include <set>
+#include <string>
+#include <vector>
 
 using namespace tsr;
 
@@ -65,6 +81,207 @@ TEST(testFeature, testSimpleBoolToIntegerFeature) {
   ASSERT_EQ(boolToIntFeature->Calculate(state), neg_value);
 }
 
+TEST(testFeature, testTabulatedFeatureMatchesPolynomial) {
+
+  std::vector<double> upwards = {1, -2.7, -34.83, 200.63, -292.06};
+  std::vector<double> downwards = {1, -0.01, 79.31, 1164.83, 4622.34, 5737.68};
+
+  GradientSpeedFeature gradientSpeed("GRADIENT_SPEED", upwards, downwards);
+
+  // Compare against the analytic polynomials over realistic gradients
+  for (double gradient = -0.5; gradient <= 0.5; gradient += 0.001) {
+    double expected =
+        gradient > 0 ? TabulatedFeature::SolvePolynomial(gradient, upwards)
+                     : TabulatedFeature::SolvePolynomial(gradient, downwards);
+
+    ASSERT_NEAR(gradientSpeed.Lookup(gradient), expected, 1e-3);
+  }
+}
+
+TEST(testFeature, testTabulatedFeatureMeasuredData) {
+
+  auto curve = TabulatedFeature::Measured({{0, 0}, {1, 10}, {2, 0}});
+  auto tabulated =
+      std::make_shared<TabulatedFeature>("MEASURED", curve, 0, 2, 201);
+
+  auto input = std::make_shared<ConstantFeature<double>>("INPUT", 0.5);
+  tabulated->AddDependency(input);
+
+  TsrState state;
+  ASSERT_NEAR(tabulated->Calculate(state), 5, 1e-9);
+
+  // Inputs outside the sampled range are clamped
+  ASSERT_NEAR(tabulated->Lookup(-1), 0, 1e-9);
+  ASSERT_NEAR(tabulated->Lookup(3), 0, 1e-9);
+  ASSERT_NEAR(tabulated->Lookup(1), 10, 1e-9);
+}
+
+TEST(testFeature, testComposedCostNodes) {
+
+  PresetFeatures features;
+  TsrState state;
+
+  Cost::Product<Cost::Constant<std::ratio<2>>,
+                Cost::Inverse<Cost::Constant<std::ratio<4>>>>
+      product(features);
+  ASSERT_DOUBLE_EQ(product.Calculate(state), 0.5);
+
+  // Matches InverseFeature, where a zero speed is untraversable
+  Cost::Time<Cost::Constant<std::ratio<2>>,
+             Cost::Inverse<Cost::Constant<std::ratio<0>>>>
+      untraversable(features);
+  ASSERT_EQ(untraversable.Calculate(state),
+            std::numeric_limits<double>::infinity());
+}
+
+TEST(testFeature, testFeatureProfileNestedScopes) {
+
+  FeatureProfile parent;
+  FeatureProfile child;
+
+  {
+    FeatureProfileScope parentScope(parent);
+    FeatureProfileScope childScope(child);
+  }
+
+  ASSERT_EQ(parent.calls, 1);
+  ASSERT_EQ(child.calls, 1);
+
+  // Time spent in the child is excluded from the parent's self time
+  ASSERT_LE(parent.self_ns + child.total_ns, parent.total_ns + 1);
+
+  FeatureProfile profile;
+  profile.RecordCall(100, 100);
+  profile.RecordCall(1000, 1000);
+  ASSERT_EQ(profile.Percentile(0.5), 128);
+  ASSERT_EQ(profile.Percentile(1), 1024);
+}
+
+TEST(testFeature, testFeatureProfileJsonEscapesIDs) {
+
+  FeatureProfileEntry entry;
+  entry.feature_id = "a\"b\\c\n";
+  entry.profile.RecordCall(100, 100);
+
+  std::string json = FormatFeatureProfileJson({entry});
+  ASSERT_NE(json.find("\"feature\": \"a\\\"b\\\\c\\n\""),
+            std::string::npos);
+}
+
+/// Raster feature recording the tagging pass each face was last tagged in
+class StubRasterFeature : public RasterFeature {
+private:
+  ChunkManager chunk_manager = ChunkManager("", 0.1, {0, 1, 2, 3}, "");
+
+public:
+  std::vector<int> tags;
+  int pass = 0;
+
+  std::string GetRasterCacheID() const override { return "tsr_test_stub"; }
+
+  const ChunkManager &GetRasterChunkManager() const override {
+    return chunk_manager;
+  }
+
+  GDALDataType GetRasterDataType() const override { return GDT_Byte; }
+
+  void ResizeTags(std::size_t face_count) override {
+    tags.resize(face_count, -1);
+  }
+
+  std::vector<std::uint8_t> ExportTags() const override {
+    return std::vector<std::uint8_t>(tags.begin(), tags.end());
+  }
+
+  void ImportTags(const std::uint8_t *data, std::size_t count) override {
+    tags.assign(data, data + count);
+  }
+
+  void TagFace(Face_handle face, const Point3 &sample,
+               const RasterTile *tile) override {
+    tags[face->tag_id()] = pass;
+  }
+};
+
+TEST(testFeature, testRetagOnlyChangedFaces) {
+
+  // UTM zone 30 coordinates, so the faces convert to WGS84 when tagged
+  const double EASTING = 500000;
+  const double NORTHING = 6200000;
+
+  std::vector<Point3> points;
+  for (int y = 0; y < 10; y++) {
+    for (int x = 0; x < 10; x++) {
+      points.push_back(Point3(EASTING + x * 10, NORTHING + y * 10, 0));
+    }
+  }
+  Tin tin = CreateTinFromPoints(points);
+
+  StubRasterFeature feature;
+  FaceTagger tagger;
+  tagger.AddFeature(feature);
+  tagger.SetParallel(false);
+
+  feature.pass = 1;
+  tagger.Tag(tin);
+  ASSERT_TRUE(tagger.Retag(tin).empty());
+
+  // A constraint across one corner splits and flips only nearby faces
+  tin.insert_constraint(Point3(EASTING + 1, NORTHING + 1, 0),
+                        Point3(EASTING + 25, NORTHING + 15, 0));
+
+  feature.pass = 2;
+  auto changedFaces = tagger.Retag(tin);
+  ASSERT_FALSE(changedFaces.empty());
+  ASSERT_LT(changedFaces.size(), tin.number_of_faces() / 4);
+
+  std::set<Face_handle> changed(changedFaces.begin(), changedFaces.end());
+
+  // Tag IDs remain unique, changed faces are tagged again and the rest keep
+  // their tags
+  std::set<std::uint32_t> tagIDs;
+  for (Face_handle face : tin.finite_face_handles()) {
+    ASSERT_TRUE(tagIDs.insert(face->tag_id()).second);
+    ASSERT_LT(face->tag_id(), feature.tags.size());
+    ASSERT_EQ(feature.tags[face->tag_id()], changed.count(face) ? 2 : 1);
+  }
+
+  ASSERT_TRUE(tagger.Retag(tin).empty());
+}
+
+TEST(testFeature, testRetagAfterVertexReplaced) {
+
+  std::vector<Point3> points;
+  for (int y = 0; y < 10; y++) {
+    for (int x = 0; x < 10; x++) {
+      points.push_back(Point3(x * 10, y * 10, 0));
+    }
+  }
+  Tin tin = CreateTinFromPoints(points);
+
+  FaceTagger tagger;
+  tagger.Tag(tin);
+
+  // The removed vertex's storage is reused by the inserted vertex, which
+  // must still be detected as a change
+  Face_handle face = tin.locate(Point3(45, 45, 0));
+  tin.remove(face->vertex(0));
+  Vertex_handle inserted = tin.insert(Point3(43, 47, 0));
+
+  auto changedFaces = tagger.Retag(tin);
+  std::set<Face_handle> changed(changedFaces.begin(), changedFaces.end());
+
+  Tin::Face_circulator incident = tin.incident_faces(inserted);
+  Tin::Face_circulator done = incident;
+  do {
+    ASSERT_EQ(changed.count(Face_handle(incident)), 1);
+  } while (++incident != done);
+
+  // Copies keep their vertex IDs, so are not retagged
+  Tin copy = tin;
+  ASSERT_TRUE(tagger.Retag(copy).empty());
+}
+
 TEST(TestFeature, testCEHFeatureInitialization) {
 
   Point3 src(56.317649, -2.816415, 0);